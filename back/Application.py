@@ -34,6 +34,15 @@ class OCRMode(Enum):
     BLOCK = auto()
 
 
+class TesseractLine:
+    """A line recognized by Tesseract with its geometry (bbox is (x0, y0, x1, y1) in page coordinates)"""
+    def __init__(self, transcription, bbox, confidence, words):
+        self.transcription = transcription
+        self.bbox = bbox
+        self.confidence = confidence
+        self.words = words
+
+
 class App:
 
     def __init__(self, PERO_CONFIG_DIR, logger = None, logging_level = logging.INFO):
@@ -64,7 +73,7 @@ class App:
         self._logger.info("Segment extraction in %.1f ms", 1e-6 * (end - start))
 
         start = time.process_time_ns()
-        angle, segments, deskewed = scribo.deskew(input, segments, scribocxx.KConfig.kAngleTolerance)
+        angle, segments, deskewed = scribo.deskew(input, segments, scribocxx.KConfig().kAngleTolerance)
         end = time.process_time_ns()
         self._logger.info("Document deskew in %.1f ms", 1e-6 * (end - start))
         return (segments, deskewed)
@@ -148,46 +157,16 @@ class App:
     def process(self, input: np.ndarray, font_size = -1, disable_OCR = False, disable_NER=False, ocr_engine=OCREngine.PERO):
         input = self._rescale(input)
 
+        # Cleaning, blocks, lines and entries in a single native call
         start = time.process_time_ns()
-        clean, params = scribo.clean_document(input, -1, font_size)
+        options = scribocxx.PageOptions()
+        options.xheight = font_size
+        options.denoise = 0
+        clean, _, table, params = scribo.process_page(input, options)
+        regions = scribo.regions_from_table(table)
         end = time.process_time_ns()
-        self._logger.info("Cleaning in %.1f ms", 1e-6 * (end - start))
-
-        start = time.process_time_ns()
-        segments = scribo.extract_segments(input)
-        segments = scribo.deskew_segments(segments, params["deskew_angle"])
-        end = time.process_time_ns()
-        self._logger.info("Segmeent extraction in %.1f ms", 1e-6 * (end - start))
-
-
-        scale = 1
-        config = scribocxx.KConfig(params["xheight"], scale)
-
-        # Hack to make a C-contiguous array
-        clean = clean.copy()
-
-        start = time.process_time_ns()
-        regions = scribo.XYCutLayoutExtraction(clean, segments, config)
-        end = time.process_time_ns()
-        self._logger.info("Block extraction in %.1f ms", 1e-6 * (end - start))
-
-        ## Line segmentation
-        start = time.process_time_ns()
-        text_block_indexes, text_blocks = zip(*[ (i, r.bbox) for i,r in enumerate(regions) if r.type  == scribocxx.DOMCategory.COLUMN_LEVEL_2])
-        text_block_indexes = np.array(text_block_indexes)
-        debug_prefix = "debug-05" if self._logging_level == logging.DEBUG else ""
-        ws, lines = scribo.WSLineExtraction(clean, text_blocks, config, debug_prefix=debug_prefix)
-        for i, l in enumerate(lines):
-            l.parent_id = text_block_indexes[l.parent_id]
-        end = time.process_time_ns()
-        self._logger.info("Line extraction in %.1f ms", 1e-6 * (end - start))
-
-        ## Extract entries (and push them in regions)
-        start = time.process_time_ns()
-        regions = scribo.EntryExtraction(regions, lines)
-        end = time.process_time_ns()
-        self._logger.info("Entry extraction in %.1f ms", 1e-6 * (end - start))
-
+        self._logger.info("Layout extraction in %.1f ms (x-height: %d, deskew angle: %.2f)", 1e-6 * (end - start),
+                          params["xheight"], params["deskew_angle"])
 
         # OCR
         if not disable_OCR:
@@ -259,7 +238,17 @@ class App:
 
         elif ocr_engine is OCREngine.TESSERACT: 
             boxes = [r.bbox for r in valid_regions]
-            ocr_results = scribo.TesseractTextExtraction(input, boxes)
+            _, ocr_boxes = scribo.TesseractTextExtraction(input, boxes, is_line=(ocr_mode == OCRMode.LINE), with_boxes=True)
+            # Group the lines (followed by their words) by region
+            ocr_results = [ [] for _ in valid_regions ]
+            for b in ocr_boxes:
+                bbox = (b.bbox.x0(), b.bbox.y0(), b.bbox.x1(), b.bbox.y1())
+                if b.level == scribocxx.OCRLevel.LINE:
+                    ocr_results[b.region_id].append(TesseractLine(b.text.rstrip("\n"), bbox, b.confidence, []))
+                elif ocr_results[b.region_id]:
+                    ocr_results[b.region_id][-1].words.append({"bbox": bbox, "confidence": b.confidence, "transcription": b.text})
+            for e, lines in zip(valid_regions, ocr_results):
+                e.line_data = lines
 
         if len(ocr_results) != len(valid_regions):
             self._logger.critical("Internal error: the number of processed boxes mismatch.")
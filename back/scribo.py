@@ -1,6 +1,5 @@
 from __future__ import annotations
-import itertools
-from typing import Dict, List, Tuple
+from typing import Callable, Dict, List, Optional, Tuple
 import numpy as np
 import json
 
@@ -37,8 +36,18 @@ class ScriboJSONEncoder(json.JSONEncoder):
         return super().default(o)
 
 
-def extract_segments(input):
-    segments = scribocxx._extract_segments(input)
+def extract_segments(input, n_bands=1, method=scribocxx.SegmentDetectionMethod.LSD):
+    """Detect the segments (separators) in an image.
+
+    Args:
+        input (np.ndarray): Input image
+        n_bands (int, optional): (LSD only) Number of horizontal bands processed in parallel (1: whole page, 0: one per core)
+        method (scribocxx.SegmentDetectionMethod, optional): LSD or KALMAN (faster, long rules only)
+
+    Returns:
+        list: The list of detected segments
+    """
+    segments = scribocxx._extract_segments(input, n_bands, method)
     return segments
 
 def deskew_segments(input, angle):
@@ -105,21 +114,63 @@ def clean_document(input: np.ndarray, xwidth = -1, xheight = -1, denoise = False
 
 
 
-def EntryExtraction(regions: List[scribocxx.LayoutRegion], lines: List[scribocxx.LayoutRegion]):
+def process_page(input: np.ndarray, options: scribocxx.PageOptions = None) -> Tuple:
+    """Run the whole layout pipeline (cleaning, segments, blocks, lines, entries) in a single native call
+
+    Args:
+        input (np.ndarray): Input image (uint8)
+        options (scribocxx.PageOptions, optional): Pipeline options (x-height, denoising, entry model...)
+
+    Returns:
+        tuple: (clean image, watershed labels, regions, cleaning parameters) where the regions are a numpy structured
+        array of dtype `scribocxx.region_dtype` (x, y, w, h, type, parent_id, mask_instance_id) and the parameters are
+        as in `clean_document`.
+    """
+    if options is None:
+        options = scribocxx.PageOptions()
+    return scribocxx.process_page(input, options)
+
+
+def process_pages(inputs: List[np.ndarray], options: scribocxx.PageOptions = None, n_threads: int = 0,
+                  callback: Callable[[int, Tuple], None] = None) -> Optional[List[Tuple]]:
+    """Run process_page on several pages in parallel on native threads
+
+    Args:
+        inputs (list[np.ndarray]): Input images (uint8)
+        options (scribocxx.PageOptions, optional): Pipeline options, shared by all the pages
+        n_threads (int, optional): Number of pages processed concurrently (0: one per core)
+        callback (callable, optional): Called as `callback(index, result)` for each page, in order, as soon as its
+            result is available. Only a few pages are processed ahead of the callback, so the memory stays bounded.
+
+    Returns:
+        list: The results of the pages in order (as in process_page), or None if a callback is given
+    """
+    if options is None:
+        options = scribocxx.PageOptions()
+    return scribocxx.process_pages(inputs, options, n_threads, callback)
+
+
+def regions_from_table(table: np.ndarray) -> List[scribocxx.LayoutRegion]:
+    """Build the LayoutRegion objects from a region array (see process_page)"""
+    return scribocxx.regions_from_array(table)
+
+
+def EntryExtraction(regions: List[scribocxx.LayoutRegion], lines: List[scribocxx.LayoutRegion], model: scribocxx.EntryModel = None):
     """Estimate the entries from a list of lines and add them to the region list. The new regions
         have type "ENTRY" and the parent id of corresponding lines are updated.
 
     Args:
-        regions (list[scribocxx.LayoutRegion]): The list of regions
-        lines (list[scribocxx.LayoutRegion]): The sublist of regions that are lines
+        regions (list[scribocxx.LayoutRegion]): The list of regions (or an array of dtype scribocxx.region_dtype, then
+            `lines` must be an array as well)
+        lines (list[scribocxx.LayoutRegion]): The sublist of regions that are lines (grouped by parent)
+        model (scribocxx.EntryModel): The line classifier (see scribocxx.EntryModel.load). Defaults to the built-in model.
 
     Returns:
         list[scribocxx.LayoutRegion]: The new list of regions with new entries
     """
-    newlines = []
-    for id, group in itertools.groupby(lines, lambda x: x.parent_id):
-        regions, newlines_ = scribocxx._EntryExtraction(regions[id].bbox, list(group), regions)
-        newlines.extend(newlines_)
+    regions, newlines = scribocxx._EntryExtractionBatch(lines, regions, model)
+    if isinstance(regions, np.ndarray):
+        return np.concatenate([regions, newlines])
     regions.extend(newlines)
     return regions
 
@@ -140,7 +191,22 @@ def XYCutLayoutExtraction(input: np.ndarray, segments: List, config: scribocxx.K
 
 
 
-def TesseractTextExtraction(input: np.ndarray, regions: List[scribocxx.LayoutRegion], is_line=False):
+def TesseractTextExtraction(input: np.ndarray, regions: List[scribocxx.LayoutRegion], is_line=False, with_boxes=False):
+    """Run Tesseract on each region
+
+    Args:
+        input (np.ndarray): Input image
+        regions (list[scribocxx.box]): The regions to process
+        is_line (bool): The regions are single lines
+        with_boxes (bool): Also return the lines and words found by Tesseract
+
+    Returns:
+        list[str] | (list[str], list[scribocxx.OCRBox]): The text of each (non-empty) region and, if `with_boxes`, the
+        lines and words of all the regions in a single list (`region_id` is the index of the region, each line is
+        followed by its words).
+    """
+    if with_boxes:
+        return scribocxx._TesseractTextExtractionWithBoxes(input, regions, is_line=is_line)
     texts = scribocxx._TesseractTextExtraction(input, regions, is_line=is_line)
     return texts
 
@@ -4,6 +4,7 @@ import numpy as np
 import pathlib
 import logging
 import re
+from concurrent.futures import ThreadPoolExecutor
 
 import progressbar
 from PIL import Image
@@ -100,11 +101,21 @@ parser.add_argument(
         help="Skip the NER processing",
         )
 
+parser.add_argument(
+        "-j", "--jobs",
+        dest="jobs",
+        type=int,
+        default=1,
+        required=False,
+        help="Number of pages processed concurrently (threads)",
+        )
+
 args = parser.parse_args()
 vargs = vars(args)
 input_file = vargs.pop("file")
 output_pattern = vargs.pop("outfile_pattern")
 layout_file_pattern = vargs.pop("layout_file_pattern", None)
+jobs = vargs.pop("jobs")
 
 
 def run(page):
@@ -115,20 +126,26 @@ def run(page):
             img = img.convert("L")
             img = np.array(img)
 
-        vargs["output_json"] = output_pattern.format(page)
-        vargs["log_level"] = logging.WARNING
+        kwargs = dict(vargs) # Per page copy (pages may run concurrently)
+        kwargs["output_json"] = output_pattern.format(page)
+        kwargs["log_level"] = logging.WARNING
         if layout_file_pattern:
-            vargs["layout_file"] = layout_file_pattern.format(page)
-        process_options(img,**vargs)
+            kwargs["layout_file"] = layout_file_pattern.format(page)
+        process_options(img,**kwargs)
     except:
         logging.exception("An error occured when processing the page %d from %s.", page, input_file)
         return
 
 def doExecutor():
-    #with ThreadPoolExecutor(max_workers=1) as executor:
-    #    executor.map(do, args.pages)
     pages = vargs.pop("pages")
-    for p in progressbar.progressbar(pages, redirect_stdout=True):
-        run(p)
+    if jobs <= 1:
+        for p in progressbar.progressbar(pages, redirect_stdout=True):
+            run(p)
+        return
+
+    # The heavy scribocxx functions release the GIL, so the pages are processed in parallel
+    with ThreadPoolExecutor(max_workers=jobs) as executor:
+        for _ in progressbar.progressbar(executor.map(run, pages), max_value=len(pages), redirect_stdout=True):
+            pass
 
 doExecutor()
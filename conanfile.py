@@ -37,6 +37,7 @@ class Recipe(ConanFile):
         self.requires("boost/1.81.0", override=True)
 
         self.test_requires("gtest/[^1.12]")
+        self.test_requires("benchmark/[^1.8]")
 
 
 
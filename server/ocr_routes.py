@@ -58,6 +58,8 @@ def ocr_regions(ocr_engine: str):
         ```
         {"id": id_line, "polygon": list of points, "transcription": text}
         ```
+        With tesseract, lines also have a "confidence" (0-100) and a list of "words"
+        (`{"bbox": [tlx, tly, brx, bry], "confidence": c, "transcription": text}`).
 
         Example (Python):
         ```
@@ -170,6 +172,20 @@ def ocr_regions(ocr_engine: str):
     transcriptions_with_ids = []
     for r, reg in zip(regions, layout_regions):
         lines = []
+        if hasattr(reg, "line_data"):
+            # Tesseract gives the geometry of the lines along with the text (no need for a second pass)
+            for l_id, l in enumerate(reg.line_data):
+                x0, y0, x1, y1 = l.bbox
+                lines.append({
+                    "id": f"{r['id']}_l{l_id}",
+                    "polygon": [[x0, y0], [x1, y0], [x1, y1], [x0, y1]],
+                    "confidence": l.confidence,
+                    "transcription": l.transcription,
+                    "words": l.words,
+                    })
+            transcriptions_with_ids.append({"id": r["id"], "lines": lines})
+            continue
+
         for l_id, line_data in enumerate(reg.text_ocr.split("\n")):
         # for l_id, l in enumerate(reg.line_data):
             line_data = {
@@ -335,6 +351,8 @@ def ocr_lines(ocr_engine: str):
             "id": id,
             "transcription": line.text_ocr
             }
+        if getattr(line, "line_data", None):
+            line_result["confidence"] = min(l.confidence for l in line.line_data)
         transcriptions_with_ids.append(line_result)
         
     return jsonify({
@@ -0,0 +1,51 @@
+#include "bench_pages.hpp"
+#include "../src/detect_separators.hpp"
+
+
+// Speed and recall of the separator detectors:
+// * recall: fraction of the segments of the whole-page LSD found by the detector
+// * rules_recall: fraction of the rules drawn on the page found by the detector (synthetic pages only)
+
+static void report_recall(benchmark::State& state, const bench::page& page, const std::vector<Segment>& segments)
+{
+  auto reference = scribo::extract_segments(page.input);
+
+  state.counters["segments"] = segments.size();
+  state.counters["recall"]   = bench::segment_recall(reference, segments, 2);
+  if (page.synthetic)
+    state.counters["rules_recall"] = bench::segment_recall(page.rules, segments, 4);
+}
+
+// LSD on the whole page (1 band) or tiled (one band per task), Kalman line tracker
+static void BM_Segments(benchmark::State& state, scribo::segment_detection_parameters::Method method, int n_bands)
+{
+  auto* page = bench::get_page(state);
+  if (!page)
+    return;
+
+  scribo::segment_detection_parameters params;
+  params.method  = method;
+  params.n_bands = n_bands;
+
+  std::vector<Segment>      segments;
+  bench::allocation_counter alloc;
+  for (auto _ : state)
+  {
+    segments = scribo::extract_segments(page->input, params);
+    benchmark::DoNotOptimize(segments.data());
+  }
+  alloc.report(state);
+  state.SetItemsProcessed(state.iterations() * page->input.width() * page->input.height());
+  report_recall(state, *page, segments);
+}
+
+static void page_args(benchmark::internal::Benchmark* b)
+{
+  b->ArgName("page")->DenseRange(0, bench::kPageCount - 1)->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+BENCHMARK_CAPTURE(BM_Segments, LSD, scribo::segment_detection_parameters::LSD, 1)->Apply(page_args);
+BENCHMARK_CAPTURE(BM_Segments, LSD_2_bands, scribo::segment_detection_parameters::LSD, 2)->Apply(page_args);
+BENCHMARK_CAPTURE(BM_Segments, LSD_4_bands, scribo::segment_detection_parameters::LSD, 4)->Apply(page_args);
+BENCHMARK_CAPTURE(BM_Segments, LSD_8_bands, scribo::segment_detection_parameters::LSD, 8)->Apply(page_args);
+BENCHMARK_CAPTURE(BM_Segments, Kalman, scribo::segment_detection_parameters::KALMAN, 1)->Apply(page_args);
@@ -0,0 +1,231 @@
+#include "bench_pages.hpp"
+#include "../src/config.hpp"
+#include "../src/display.hpp"
+#include "../src/export.hpp"
+#include "../src/subsample.hpp"
+
+#include <mln/core/algorithm/clone.hpp>
+
+#include <sstream>
+
+
+// One benchmark per stage of the pipeline, fed with the intermediate results of the pipeline on the page. The
+// throughput is reported in pixels/s of the stage input (items_per_second) with the memory allocated per iteration.
+// The stages may run on several threads, so the wall-clock time is measured.
+
+static void set_pixels_processed(benchmark::State& state, const mln::image2d<uint8_t>& input)
+{
+  state.SetItemsProcessed(state.iterations() * input.width() * input.height());
+}
+
+static void BM_Resize(benchmark::State& state)
+{
+  auto* page = bench::get_page(state);
+  if (!page)
+    return;
+
+  float scale = state.range(1) / 100.f;
+
+  bench::allocation_counter alloc;
+  for (auto _ : state)
+  {
+    auto out = resize(page->input, scale);
+    benchmark::DoNotOptimize(out.buffer());
+  }
+  alloc.report(state);
+  set_pixels_processed(state, page->input);
+}
+
+static void BM_BackgroundSubstraction(benchmark::State& state)
+{
+  auto* page = bench::get_page(state);
+  if (!page)
+    return;
+
+  bench::allocation_counter alloc;
+  for (auto _ : state)
+  {
+    int  xwidth = -1, xheight = -1;
+    auto out    = scribo::background_substraction(page->inverted, xwidth, xheight, page->result.cleaning.denoise);
+    benchmark::DoNotOptimize(out.buffer());
+  }
+  alloc.report(state);
+  set_pixels_processed(state, page->inverted);
+}
+
+static void BM_SkewEstimation(benchmark::State& state)
+{
+  auto* page = bench::get_page(state);
+  if (!page)
+    return;
+
+  const auto& params = page->result.cleaning;
+
+  bench::allocation_counter alloc;
+  for (auto _ : state)
+    benchmark::DoNotOptimize(scribo::skew_estimation(page->background, params.xwidth, params.xheight));
+  alloc.report(state);
+  set_pixels_processed(state, page->background);
+}
+
+static void BM_DeskewImage(benchmark::State& state)
+{
+  auto* page = bench::get_page(state);
+  if (!page)
+    return;
+
+  bench::allocation_counter alloc;
+  for (auto _ : state)
+  {
+    auto out = scribo::deskew_image(page->input, 1.5f);
+    benchmark::DoNotOptimize(out.buffer());
+  }
+  alloc.report(state);
+  set_pixels_processed(state, page->input);
+}
+
+static void BM_ExtractSegments(benchmark::State& state)
+{
+  auto* page = bench::get_page(state);
+  if (!page)
+    return;
+
+  bench::allocation_counter alloc;
+  for (auto _ : state)
+  {
+    auto segments = scribo::extract_segments(page->input);
+    benchmark::DoNotOptimize(segments.data());
+  }
+  alloc.report(state);
+  set_pixels_processed(state, page->input);
+}
+
+static void BM_XYCutLayoutExtraction(benchmark::State& state)
+{
+  auto* page = bench::get_page(state);
+  if (!page)
+    return;
+
+  const auto& res    = page->result;
+  auto        config = KConfig(res.cleaning.xheight, 1);
+
+  bench::allocation_counter alloc;
+  for (auto _ : state)
+  {
+    auto segments = res.segments;
+    auto regions  = scribo::XYCutLayoutExtraction(res.clean, segments, config);
+    benchmark::DoNotOptimize(regions.data());
+  }
+  alloc.report(state);
+  set_pixels_processed(state, res.clean);
+}
+
+static void BM_WSLineExtraction(benchmark::State& state)
+{
+  auto* page = bench::get_page(state);
+  if (!page)
+    return;
+
+  const auto& res    = page->result;
+  auto        config = KConfig(res.cleaning.xheight, 1);
+  auto        boxes  = page->text_boxes;
+
+  bench::allocation_counter alloc;
+  for (auto _ : state)
+  {
+    std::vector<scribo::LayoutRegion> lines;
+    auto ws = scribo::WSLineExtractionAnyLabel(res.clean, boxes, "", config, &lines);
+    benchmark::DoNotOptimize(ws.buffer());
+  }
+  alloc.report(state);
+  set_pixels_processed(state, res.clean);
+}
+
+static void BM_EntryExtraction(benchmark::State& state)
+{
+  auto* page = bench::get_page(state);
+  if (!page)
+    return;
+
+  // The blocks and the lines of the page (the entries are recomputed)
+  const auto&                       all    = page->result.regions;
+  const auto&                       lines0 = page->lines;
+  std::vector<scribo::LayoutRegion> regions(all.begin(), all.begin() + page->nblocks);
+  std::vector<scribo::LayoutRegion> lines = lines0;
+  regions.reserve(all.size());
+
+  bench::allocation_counter alloc;
+  for (auto _ : state)
+  {
+    std::ranges::copy(lines0, lines.begin());
+    regions.resize(page->nblocks);
+    scribo::EntryExtraction(lines, regions);
+    benchmark::DoNotOptimize(regions.data());
+  }
+  alloc.report(state);
+  state.SetItemsProcessed(state.iterations() * lines0.size());
+  state.counters["lines"] = lines0.size();
+}
+
+static void BM_ToJson(benchmark::State& state)
+{
+  auto* page = bench::get_page(state);
+  if (!page)
+    return;
+
+  const auto& regions = page->result.regions;
+
+  bench::allocation_counter alloc;
+  std::size_t               nbytes = 0;
+  for (auto _ : state)
+  {
+    std::ostringstream ss;
+    scribo::to_json(regions, ss);
+    nbytes = ss.view().size();
+    benchmark::DoNotOptimize(nbytes);
+  }
+  alloc.report(state);
+  state.SetItemsProcessed(state.iterations() * regions.size());
+  state.SetBytesProcessed(state.iterations() * nbytes);
+}
+
+static void BM_Display(benchmark::State& state)
+{
+  auto* page = bench::get_page(state);
+  if (!page)
+    return;
+
+  auto res     = page->result;
+  auto regions = res.regions;
+  auto opts    = DISPLAY_GRID | DISPLAY_SEGMENTS | DISPLAY_WS;
+
+  bench::allocation_counter alloc;
+  for (auto _ : state)
+  {
+    auto out = display(res.clean, regions, res.segments, &res.ws, opts);
+    benchmark::DoNotOptimize(out.buffer());
+  }
+  alloc.report(state);
+  set_pixels_processed(state, res.clean);
+}
+
+
+static void page_args(benchmark::internal::Benchmark* b)
+{
+  b->ArgName("page")->DenseRange(0, bench::kPageCount - 1)->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+BENCHMARK(BM_Resize)
+    ->ArgNames({"page", "scale%"})
+    ->ArgsProduct({benchmark::CreateDenseRange(0, bench::kPageCount - 1, 1), {50, 150}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_BackgroundSubstraction)->Apply(page_args);
+BENCHMARK(BM_SkewEstimation)->Apply(page_args);
+BENCHMARK(BM_DeskewImage)->Apply(page_args);
+BENCHMARK(BM_ExtractSegments)->Apply(page_args);
+BENCHMARK(BM_XYCutLayoutExtraction)->Apply(page_args);
+BENCHMARK(BM_WSLineExtraction)->Apply(page_args);
+BENCHMARK(BM_EntryExtraction)->Apply(page_args)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ToJson)->Apply(page_args)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Display)->Apply(page_args);
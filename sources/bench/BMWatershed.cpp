@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+#include "../src/gaussian_directional_2d.hpp"
+#include "../src/watershed.hpp"
+
+#include <mln/core/image/ndimage.hpp>
+#include <mln/core/neighborhood/c4.hpp>
+
+#include <random>
+
+
+// A text block (lines of words) blurred as in the line extraction (x-height = 20px)
+static mln::image2d<uint8_t> make_blurred_lines(int width, int height)
+{
+  std::mt19937          gen(42);
+  mln::image2d<uint8_t> input(width, height);
+  for (int y = 0; y < height; ++y)
+    for (int x = 0; x < width; ++x)
+    {
+      bool in_line = (y % 40) >= 10 && (y % 40) < 30;
+      bool in_word = ((x / 16) % 5) != 4;
+      input({x, y}) = (in_line && in_word && gen() % 3 != 0) ? 0 : 255;
+    }
+  gaussian2d(input, 80 * 0.3f, 40 * 0.1f, 255);
+  return input;
+}
+
+static void BM_Watershed_Pylene(benchmark::State& state)
+{
+  auto input = make_blurred_lines(state.range(0), state.range(1));
+  for (auto _ : state)
+  {
+    int  nlabel;
+    auto ws = mln::morpho::watershed<int32_t>(input, mln::c4, nlabel);
+    benchmark::DoNotOptimize(ws.buffer());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(1));
+}
+
+// The pylene priority queue flooding from the same markers as the hierarchical queue
+static void BM_Watershed_PQueue(benchmark::State& state)
+{
+  auto input = make_blurred_lines(state.range(0), state.range(1));
+  for (auto _ : state)
+  {
+    mln::image2d<int32_t> ws;
+    ws.resize(input.domain());
+    int nlabel = impl::local_minima(input, ws);
+    impl::watershed_pqueue(input, mln::c4, ws, nlabel);
+    benchmark::DoNotOptimize(ws.buffer());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(1));
+}
+
+static void BM_Watershed_HQueue(benchmark::State& state)
+{
+  auto input = make_blurred_lines(state.range(0), state.range(1));
+  for (auto _ : state)
+  {
+    int  nlabel;
+    auto ws = impl::watershed<int32_t>(input, mln::c4, nlabel);
+    benchmark::DoNotOptimize(ws.buffer());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(1));
+}
+
+BENCHMARK(BM_Watershed_Pylene)->Args({500, 1500})->Args({1000, 3000})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Watershed_PQueue)->Args({500, 1500})->Args({1000, 3000})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Watershed_HQueue)->Args({500, 1500})->Args({1000, 3000})->Unit(benchmark::kMillisecond);
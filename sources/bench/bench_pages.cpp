@@ -0,0 +1,284 @@
+#include "bench_pages.hpp"
+
+#include <mln/core/algorithm/clone.hpp>
+#include <mln/core/algorithm/transform.hpp>
+#include <mln/data/stretch.hpp>
+#include <mln/io/imread.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+
+
+// Allocation counting (all the allocations of the program go through these operators)
+namespace
+{
+  std::atomic<std::int64_t> g_allocated_bytes = 0;
+  std::atomic<std::int64_t> g_allocation_count = 0;
+}
+
+void* operator new(std::size_t n)
+{
+  g_allocated_bytes.fetch_add(n, std::memory_order_relaxed);
+  g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(n ? n : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+
+namespace
+{
+  constexpr uint8_t kPaper = 230;
+  constexpr uint8_t kInk   = 40;
+
+  Segment make_segment(int x0, int y0, int x1, int y1, int width)
+  {
+    Segment s;
+    s.start  = {x0, y0};
+    s.end    = {x1, y1};
+    s.width  = width;
+    s.nfa    = 0;
+    s.length = std::hypot(x1 - x0, y1 - y0);
+    s.angle  = std::atan2(y1 - y0, x1 - x0) * 180 / M_PI;
+    return s;
+  }
+
+  void fill_rect(mln::image2d<uint8_t>& ima, int x0, int y0, int w, int h, uint8_t v)
+  {
+    int x1 = std::min(x0 + w, ima.width());
+    int y1 = std::min(y0 + h, ima.height());
+    for (int y = std::max(y0, 0); y < y1; ++y)
+      for (int x = std::max(x0, 0); x < x1; ++x)
+        ima({x, y}) = v;
+  }
+
+  // Run the pipeline on the page and keep the inputs of each stage
+  void prepare(bench::page& p)
+  {
+    // The pipeline may modify its input
+    p.result = scribo::process_page(mln::clone(p.input));
+
+    int xwidth  = p.result.cleaning.xwidth;
+    int xheight = p.result.cleaning.xheight;
+    p.inverted   = mln::transform(p.input, [](uint8_t x) -> uint8_t { return 255 - x; });
+    p.background = scribo::background_substraction(mln::clone(p.inverted), xwidth, xheight, p.result.cleaning.denoise);
+    mln::data::stretch_to(p.background, p.background);
+
+    p.nblocks = 0;
+    for (const auto& r : p.result.regions)
+    {
+      if (r.type == DOMCategory::LINE || r.type == DOMCategory::ENTRY)
+        break;
+      if (r.type == DOMCategory::COLUMN_LEVEL_2)
+        p.text_boxes.push_back(r.bbox);
+      p.nblocks++;
+    }
+
+    // The entry extraction has set the parent of the lines to their entry, the parent of an entry is the text block
+    const auto& regions = p.result.regions;
+    for (const auto& r : regions)
+      if (r.type == DOMCategory::LINE)
+      {
+        auto& l     = p.lines.emplace_back(r);
+        l.parent_id = regions[r.parent_id].parent_id;
+      }
+  }
+
+  std::unique_ptr<bench::page> load_page(int i)
+  {
+    auto p = std::make_unique<bench::page>();
+    switch (i)
+    {
+    case 0:
+      p->name = "Didot_1851a_300";
+      try
+      {
+        mln::io::imread(SCRIBO_TEST_DATA_DIR "/Didot_1851a_300-page.jpg", p->input);
+      }
+      catch (const std::exception&)
+      {
+        return nullptr;
+      }
+      break;
+    case 1:
+      *p = bench::make_synthetic_page(2048, 2991, 2, 1);
+      break;
+    case 2:
+      *p = bench::make_synthetic_page(2048, 2991, 3, 2);
+      break;
+    default:
+      return nullptr;
+    }
+    prepare(*p);
+    return p;
+  }
+} // namespace
+
+
+namespace bench
+{
+  std::int64_t allocated_bytes() noexcept { return g_allocated_bytes.load(std::memory_order_relaxed); }
+  std::int64_t allocation_count() noexcept { return g_allocation_count.load(std::memory_order_relaxed); }
+
+  const page* get_page(int i)
+  {
+    static std::unique_ptr<page> pages[kPageCount];
+    static bool                  loaded[kPageCount] = {};
+    if (i < 0 || i >= kPageCount)
+      return nullptr;
+    if (!loaded[i])
+    {
+      pages[i]  = load_page(i);
+      loaded[i] = true;
+    }
+    return pages[i].get();
+  }
+
+  const page* get_page(benchmark::State& state)
+  {
+    const page* p = get_page(state.range(0));
+    if (!p)
+      state.SkipWithError("Unable to load the page.");
+    else
+      state.SetLabel(p->name.c_str());
+    return p;
+  }
+
+
+  page make_synthetic_page(int width, int height, int ncols, unsigned seed)
+  {
+    std::mt19937                       gen(seed);
+    std::uniform_int_distribution<int> noise(-12, 12);
+    std::uniform_int_distribution<int> word_length(2, 9);
+    std::uniform_int_distribution<int> entry_lines(1, 3);
+    std::uniform_int_distribution<int> line_end(0, 200);
+
+    page p;
+    p.name      = fmt::format("synthetic_{}col", ncols);
+    p.synthetic = true;
+    p.input     = mln::image2d<uint8_t>(width, height);
+    fill_rect(p.input, 0, 0, width, height, kPaper);
+
+    constexpr int kMargin      = 100;
+    constexpr int kHeaderY     = 180;
+    constexpr int kGutter      = 60;
+    constexpr int kRuleWidth   = 3;
+    constexpr int kLineSpacing = 36;
+    constexpr int kXHeight     = 14;
+    constexpr int kLetterWidth = 10;
+    constexpr int kIndent      = 30;
+
+    // Header, horizontal rule and vertical rules between the columns
+    fill_rect(p.input, width / 3, 90, width / 3, 40, kInk);
+    fill_rect(p.input, kMargin, kHeaderY, width - 2 * kMargin, kRuleWidth, kInk);
+    p.rules.push_back(make_segment(kMargin, kHeaderY + 1, width - kMargin - 1, kHeaderY + 1, kRuleWidth));
+
+    int colwidth = (width - 2 * kMargin - (ncols - 1) * kGutter) / ncols;
+    for (int c = 1; c < ncols; ++c)
+    {
+      int x = kMargin + c * (colwidth + kGutter) - kGutter / 2;
+      fill_rect(p.input, x, kHeaderY + 40, kRuleWidth, height - kHeaderY - 40 - kMargin, kInk);
+      p.rules.push_back(make_segment(x + 1, kHeaderY + 40, x + 1, height - kMargin - 1, kRuleWidth));
+    }
+
+    // Entries: the first line starts at the left of the column, the next ones are indented
+    for (int c = 0; c < ncols; ++c)
+    {
+      int x0 = kMargin + c * (colwidth + kGutter);
+      int nlines_left = 0;
+      for (int y = kHeaderY + 60; y + kLineSpacing < height - kMargin; y += kLineSpacing)
+      {
+        bool first = (nlines_left == 0);
+        if (first)
+          nlines_left = entry_lines(gen);
+        nlines_left--;
+
+        int x    = x0 + (first ? 0 : kIndent);
+        int xend = x0 + colwidth - ((nlines_left == 0) ? line_end(gen) : 0);
+        while (x < xend)
+        {
+          int n = std::min(word_length(gen), (xend - x) / (kLetterWidth + 2));
+          for (int k = 0; k < n; ++k, x += kLetterWidth + 2)
+          {
+            // Letters with ascenders/descenders
+            int up   = (gen() % 4 == 0) ? 6 : 0;
+            int down = (gen() % 8 == 0) ? 5 : 0;
+            fill_rect(p.input, x, y - up, kLetterWidth, kXHeight + up + down, kInk);
+          }
+          x += 12;
+        }
+      }
+    }
+
+    for (int y = 0; y < height; ++y)
+      for (int x = 0; x < width; ++x)
+        p.input({x, y}) = static_cast<uint8_t>(std::clamp(p.input({x, y}) + noise(gen), 0, 255));
+    return p;
+  }
+
+
+  double segment_recall(std::span<const Segment> reference, std::span<const Segment> detected, double tolerance)
+  {
+    if (reference.empty())
+      return 1;
+
+    int found = 0;
+    for (const auto& r : reference)
+    {
+      double dx  = r.end.x - r.start.x;
+      double dy  = r.end.y - r.start.y;
+      double len = std::hypot(dx, dy);
+      if (len == 0)
+        continue;
+      dx /= len;
+      dy /= len;
+
+      // Position along the reference segment and distance to its line
+      auto project = [&](Point2D q) {
+        double px = q.x - r.start.x;
+        double py = q.y - r.start.y;
+        return std::pair{px * dx + py * dy, std::abs(py * dx - px * dy)};
+      };
+
+      std::vector<std::pair<double, double>> cover;
+      for (const auto& d : detected)
+      {
+        auto [a, da] = project(d.start);
+        auto [b, db] = project(d.end);
+        if (da > tolerance || db > tolerance)
+          continue;
+        if (a > b)
+          std::swap(a, b);
+        a = std::max(a, 0.);
+        b = std::min(b, len);
+        if (a < b)
+          cover.emplace_back(a, b);
+      }
+
+      std::ranges::sort(cover);
+      double covered = 0, end = 0;
+      for (auto [a, b] : cover)
+      {
+        a = std::max(a, end);
+        if (b > a)
+        {
+          covered += b - a;
+          end = b;
+        }
+      }
+      if (covered >= 0.8 * len)
+        found++;
+    }
+    return double(found) / reference.size();
+  }
+} // namespace bench
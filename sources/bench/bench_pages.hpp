@@ -0,0 +1,80 @@
+#pragma once
+
+#include <pipeline.hpp>
+#include <scribo.hpp>
+
+#include <mln/core/image/ndimage.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+
+/// Page corpus of the benchmarks: the pages of test/data and synthetic directory pages
+namespace bench
+{
+  struct page
+  {
+    std::string           name;
+    mln::image2d<uint8_t> input; // Grayscale page, 2048px wide (no resize in the pipeline)
+    std::vector<Segment>  rules; // The separators drawn on the page (synthetic pages only)
+    bool                  synthetic = false;
+
+    // Inputs of the stages, from a run of the pipeline on the page
+    mln::image2d<uint8_t> inverted;   // Input of the background suppression
+    mln::image2d<uint8_t> background; // Output of the background suppression (input of the skew estimation)
+    scribo::page_result   result;
+    std::vector<Box>      text_boxes; // The text blocks (input of the line extraction)
+    int                   nblocks;    // Number of regions before the lines in result.regions
+
+    // The lines of result.regions with their text block as parent (input of the entry extraction)
+    std::vector<scribo::LayoutRegion> lines;
+  };
+
+  /// Number of pages in the corpus (the benchmarks take the page index as first argument)
+  constexpr int kPageCount = 3;
+
+  /// The page `i`, loaded and processed on first use (nullptr if it cannot be loaded)
+  const page* get_page(int i);
+
+  /// Same as get_page() but the benchmark is skipped on error and its label is set to the page name
+  const page* get_page(benchmark::State& state);
+
+  /// Draw a directory page with `ncols` columns of entries, separated by vertical rules below a horizontal one
+  page make_synthetic_page(int width, int height, int ncols, unsigned seed);
+
+  /// \brief Fraction of the reference segments covered (at 80%) by the detected ones
+  ///
+  /// A detected segment covers a part of a reference segment if both its end-points are at most `tolerance` pixels
+  /// away from the line of the reference segment.
+  double segment_recall(std::span<const Segment> reference, std::span<const Segment> detected, double tolerance);
+
+  /// Number of bytes/blocks allocated with operator new since the start of the program
+  std::int64_t allocated_bytes() noexcept;
+  std::int64_t allocation_count() noexcept;
+
+  /// Report the memory allocated per iteration (counters "bytes_allocated" and "allocations")
+  class allocation_counter
+  {
+  public:
+    allocation_counter() noexcept
+      : m_bytes{allocated_bytes()}
+      , m_count{allocation_count()}
+    {
+    }
+
+    void report(benchmark::State& state) const
+    {
+      state.counters["bytes_allocated"] =
+          benchmark::Counter(allocated_bytes() - m_bytes, benchmark::Counter::kAvgIterations, benchmark::Counter::kIs1024);
+      state.counters["allocations"] = benchmark::Counter(allocation_count() - m_count, benchmark::Counter::kAvgIterations);
+    }
+
+  private:
+    std::int64_t m_bytes;
+    std::int64_t m_count;
+  };
+} // namespace bench
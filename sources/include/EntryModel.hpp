@@ -0,0 +1,235 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace scribo
+{
+
+  /// Features of a line used to decide if it starts an entry
+  enum EntryFeature
+  {
+    kEntryLeftSpace      = 0, // Distance to the left border of the column
+    kEntryLeftSpaceGrad  = 1, // Absolute difference with the left space of the previous line
+    kEntryPrevRightSpace = 2, // Right space of the previous line / column width
+    kEntryFeatureCount   = 3,
+  };
+
+
+  /// \brief Node of a decision tree, as exported by scikit-learn (``tree_`` attributes)
+  ///
+  /// A node is a leaf if `left < 0`. Otherwise, the test is `x[feature] <= threshold` (true -> left child).
+  struct tree_node
+  {
+    int    left;
+    int    right;
+    int    feature;
+    double threshold;
+    float  value;
+  };
+
+
+  namespace details
+  {
+    // Largest float <= t, so that `x <= t` and `x <= float_floor(t)` agree for any float x
+    constexpr float float_floor(double t)
+    {
+      float f = static_cast<float>(t);
+      if (static_cast<double>(f) <= t)
+        return f;
+      auto bits = std::bit_cast<std::uint32_t>(f);
+      if (f > 0)
+        return std::bit_cast<float>(bits - 1);
+      else if (f < 0)
+        return std::bit_cast<float>(bits + 1);
+      else
+        return -std::numeric_limits<float>::denorm_min();
+    }
+
+    constexpr int tree_depth(std::span<const tree_node> nodes, int i = 0)
+    {
+      if (nodes[i].left < 0)
+        return 0;
+      int a = tree_depth(nodes, nodes[i].left);
+      int b = tree_depth(nodes, nodes[i].right);
+      return 1 + (a > b ? a : b);
+    }
+
+    // Write the subtree rooted at `i` at the position `pos` of a complete tree of depth `depth` (breadth-first
+    // order). Leaves above the last level are turned into always-left tests so that every path has the same length.
+    constexpr void flatten_tree(std::span<const tree_node> nodes, int i, int pos, int level, int depth,
+                                std::uint8_t* feature, float* threshold, float* leaves)
+    {
+      const int ninternal = (1 << depth) - 1;
+      if (level == depth)
+      {
+        leaves[pos - ninternal] = nodes[i].value;
+        return;
+      }
+
+      if (nodes[i].left < 0)
+      {
+        feature[pos]   = 0;
+        threshold[pos] = std::numeric_limits<float>::infinity();
+        flatten_tree(nodes, i, 2 * pos + 1, level + 1, depth, feature, threshold, leaves);
+        flatten_tree(nodes, i, 2 * pos + 2, level + 1, depth, feature, threshold, leaves);
+      }
+      else
+      {
+        feature[pos]   = static_cast<std::uint8_t>(nodes[i].feature);
+        threshold[pos] = float_floor(nodes[i].threshold);
+        flatten_tree(nodes, nodes[i].left, 2 * pos + 1, level + 1, depth, feature, threshold, leaves);
+        flatten_tree(nodes, nodes[i].right, 2 * pos + 2, level + 1, depth, feature, threshold, leaves);
+      }
+    }
+
+    // Branch-free evaluation of a flattened tree: the path length does not depend on the input
+    constexpr float eval_flat_tree(const std::uint8_t* feature, const float* threshold, const float* leaves, int depth,
+                                   const float* x)
+    {
+      int i = 0;
+      for (int d = 0; d < depth; ++d)
+        i = 2 * i + 1 + (x[feature[i]] > threshold[i]);
+      return leaves[i - ((1 << depth) - 1)];
+    }
+  } // namespace details
+
+
+  /// \brief Decision tree flattened at compile time (complete tree of depth `Depth`, breadth-first order)
+  ///
+  /// It is a structural type, so it can be passed as a template argument (see static_entry_model).
+  template <int Depth>
+  struct static_tree
+  {
+    std::array<std::uint8_t, (1 << Depth) - 1> feature;
+    std::array<float, (1 << Depth) - 1>        threshold;
+    std::array<float, (1 << Depth)>            leaves;
+
+    constexpr float operator()(const float* x) const
+    {
+      return details::eval_flat_tree(feature.data(), threshold.data(), leaves.data(), Depth, x);
+    }
+  };
+
+  template <int Depth>
+  constexpr static_tree<Depth> make_static_tree(std::span<const tree_node> nodes)
+  {
+    static_tree<Depth> t = {};
+    details::flatten_tree(nodes, 0, 0, 0, Depth, t.feature.data(), t.threshold.data(), t.leaves.data());
+    return t;
+  }
+
+
+  /// \brief Entry model baked in at compile time
+  ///
+  /// `Clf0` (resp. `Clf1`) gives the probability that a line starts an entry when the previous line does not (resp.
+  /// does). Any constexpr callable `float(const float*)` of structural type can be used, e.g. a static_tree.
+  template <auto Clf0, auto Clf1>
+  struct static_entry_model
+  {
+    void predict(const float* x, float* p) const
+    {
+      p[0] = Clf0(x);
+      p[1] = Clf1(x);
+    }
+  };
+
+
+  /// The trees of the default model
+  inline constexpr tree_node kDefaultEntryTree0[] = {
+      {1, 8, kEntryPrevRightSpace, 0.050192078575491905, 0.f},
+      {2, 5, kEntryLeftSpaceGrad, 7.0, 0.f},
+      {3, 4, kEntryLeftSpace, 5.0, 0.f},
+      {-1, -1, 0, 0., 0.2806137080585029f},
+      {-1, -1, 0, 0., 0.009406046080173251f},
+      {6, 7, kEntryPrevRightSpace, 0.023809523321688175, 0.f},
+      {-1, -1, 0, 0., 0.5186166688750498f},
+      {-1, -1, 0, 0., 0.8073099294583558f},
+      {9, 10, kEntryLeftSpace, 15.0, 0.f},
+      {-1, -1, 0, 0., 0.9956150117952923f},
+      {11, 12, kEntryLeftSpaceGrad, 6.0, 0.f},
+      {-1, -1, 0, 0., 0.287751801205705f},
+      {13, 14, kEntryLeftSpaceGrad, 17.0, 0.f},
+      {-1, -1, 0, 0., 0.8895712641566001f},
+      {-1, -1, 0, 0., 0.5709700948212982f},
+  };
+
+  inline constexpr tree_node kDefaultEntryTree1[] = {
+      {1, 12, kEntryLeftSpaceGrad, 5.0, 0.f},
+      {2, 7, kEntryPrevRightSpace, 0.015286649111658335, 0.f},
+      {3, 6, kEntryLeftSpace, 1.0, 0.f},
+      {4, 5, kEntryPrevRightSpace, 0.0012019231216982007, 0.f},
+      {-1, -1, 0, 0., 0.23448713324461126f},
+      {-1, -1, 0, 0., 0.5701066700938181f},
+      {-1, -1, 0, 0., 0.7509394870522096f},
+      {8, 9, kEntryLeftSpace, 15.0, 0.f},
+      {-1, -1, 0, 0., 0.9902016678266132f},
+      {10, 11, kEntryPrevRightSpace, 0.05302507430315018, 0.f},
+      {-1, -1, 0, 0., 0.3559050064184852f},
+      {-1, -1, 0, 0., 0.9729120552826217f},
+      {13, 14, kEntryPrevRightSpace, 0.05557460896670818, 0.f},
+      {-1, -1, 0, 0., 0.00886907320584195f},
+      {-1, -1, 0, 0., 0.8568592722907037f},
+  };
+
+  using default_entry_model = static_entry_model<make_static_tree<4>(kDefaultEntryTree0), //
+                                                 make_static_tree<4>(kDefaultEntryTree1)>;
+
+
+  /// \brief Entry model loaded at runtime
+  ///
+  /// For each Viterbi state, the model is an ensemble of trees whose outputs are summed with a base score, optionally
+  /// followed by a sigmoid (gradient-boosted trees). A single tree with no link function is a plain decision tree.
+  /// The trees are flattened in contiguous arrays and evaluated without data-dependent branches.
+  ///
+  /// The model file is a JSON document:
+  ///
+  ///     { "classifiers": [ { "base_score": 0, "link": "identity" | "sigmoid",
+  ///                          "trees": [ { "children_left": [...], "children_right": [...],
+  ///                                       "feature": [...], "threshold": [...], "value": [...] } ] },
+  ///                        { ... } ] }
+  ///
+  /// where the classifiers are ordered as in static_entry_model.
+  class EntryModel
+  {
+  public:
+    /// The default model
+    EntryModel();
+
+    /// Load a model from a JSON file. Throws on error.
+    static EntryModel load(const std::string& path);
+    static EntryModel load(std::istream& is);
+
+    void predict(const float* x, float* p) const;
+
+  private:
+    struct tree_header
+    {
+      int depth;
+      int node_offset;
+      int leaf_offset;
+    };
+
+    struct ensemble
+    {
+      float                    base_score = 0.f;
+      bool                     sigmoid    = false;
+      std::vector<tree_header> trees;
+    };
+
+    void clear();
+    void add_tree(int state, std::span<const tree_node> nodes);
+
+    std::vector<std::uint8_t> m_feature;
+    std::vector<float>        m_threshold;
+    std::vector<float>        m_leaves;
+    ensemble                  m_classifiers[2];
+  };
+
+} // namespace scribo
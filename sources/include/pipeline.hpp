@@ -0,0 +1,55 @@
+#pragma once
+
+#include "scribo.hpp"
+
+#include <mln/core/image/ndimage.hpp>
+
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace scribo
+{
+  /// \brief Options of the whole pipeline (see process_page())
+  struct page_options
+  {
+    using Method = segment_detection_parameters::Method;
+
+    int               xwidth           = -1;                        // Force the x-width (estimated if <= 0)
+    int               xheight          = -1;                        // Force the x-height (estimated if <= 0)
+    int               denoise          = cleaning_parameters::AUTO; // Small components suppression
+    Method            segment_detector = segment_detection_parameters::LSD;
+    bool              layout           = true;    // Run the layout extraction (otherwise, the cleaning only)
+    bool              deskewed         = false;   // Also output the deskewed input (without background suppression)
+    const EntryModel* entry_model      = nullptr; // The entry classifier (the compiled-in model if null)
+    const KConfig*    config           = nullptr; // The layout tunables (the defaults if null), the x-height dependent
+                                                  // parameters are recomputed from the x-height of the page
+    int               n_threads        = 0;       // Threads of the XY-cut and line extraction (<= 0: one per core)
+  };
+
+  struct page_result
+  {
+    mln::image2d<uint8_t>     clean;    // The cleaned (and deskewed) image
+    mln::image2d<uint8_t>     deskewed; // The deskewed input (if requested)
+    cleaning_parameters       cleaning; // The estimated x-height, x-width, deskew angle...
+    std::vector<Segment>      segments; // The separators (deskewed)
+    std::vector<LayoutRegion> regions;  // The blocks, then the lines, then the entries
+    mln::ndbuffer_image       ws;       // The labels of the lines (LayoutRegion::mask_instance_id), int16 or int32
+                                        // (see WSLineExtractionAnyLabel())
+  };
+
+  /// \brief Run the whole pipeline on a page: cleaning, segment detection, XY-cut, lines and entries extraction
+  auto process_page(const mln::image2d<uint8_t>& input, const page_options& options = {}) -> page_result;
+
+  /// \brief Run process_page() on several pages in parallel
+  ///
+  /// The results are handed over to `on_result(page index, result)` in the order of the pages, from the calling
+  /// thread. The pages are started at most 2 * n_threads pages ahead of the last page handed over, so that the memory
+  /// stays bounded. If a page fails, the remaining pages are cancelled and the exception is rethrown.
+  /// \param n_threads Number of pages processed concurrently (<= 0: one per core). Unless `options.n_threads` is set,
+  /// the cores are shared between the pages (the stages of a page run sequentially when there are as many pages as
+  /// cores in flight).
+  void process_pages(std::span<const mln::image2d<uint8_t>> inputs, const page_options& options, int n_threads,
+                     const std::function<void(int, page_result&&)>& on_result);
+
+} // namespace scribo
@@ -13,13 +13,25 @@ namespace scribo
 {
   using ::DOMCategory;
 
-  /// \brief This function is not thread-safe
+  class EntryModel;
+
+  /// \brief Set the log level and the default debug level of the new configurations (see KConfig::kDebugLevel)
   void set_debug_level(int debug_level) noexcept;
   int  get_debug_level() noexcept;
 
 
+  struct segment_detection_parameters
+  {
+    enum Method { LSD = 0, KALMAN = 1 };
+
+    Method method    = LSD;
+    int n_bands      = 1;  // (LSD only) Number of horizontal bands processed in parallel (1: whole page, <= 0: one per core)
+    int band_overlap = 50; // Overlap (in pixels) between two consecutive bands
+  };
+
   /// \brief Get the segments from an image
-  auto extract_segments(const mln::image2d<uint8_t>& input) -> std::vector<Segment>;
+  auto extract_segments(const mln::image2d<uint8_t>& input, const segment_detection_parameters& params = {})
+      -> std::vector<Segment>;
 
   // Deskew facilities
   /// \{
@@ -105,19 +117,53 @@ namespace scribo
 
 
   /// \brief XY Layout Cut
-  auto XYCutLayoutExtraction(const mln::image2d<uint8_t>& input, std::span<Segment> segments, KConfig config) -> std::vector<LayoutRegion>;
+  /// \param n_threads The maximal number of threads used by the splits (<= 0: one per core, 1: sequential). The output
+  /// does not depend on it.
+  auto XYCutLayoutExtraction(const mln::image2d<uint8_t>& input, std::span<Segment> segments, KConfig config, int n_threads = 0) -> std::vector<LayoutRegion>;
 
   /// \brief Line extraction based on watershed algorithm
-  auto WSLineExtraction(const mln::image2d<uint8_t>& input, std::span<Box> regions, std::string_view debug_path, KConfig config, std::vector<LayoutRegion>* bboxes = nullptr) -> mln::image2d<int16_t>;
+  /// \tparam Label The label type of the output (int16_t or int32_t). Throws if the number of lines does not fit.
+  /// \param n_threads The maximal number of threads watershedding the regions (<= 0: one per core, 1: sequential)
+  template <class Label = int16_t>
+  auto WSLineExtraction(const mln::image2d<uint8_t>& input, std::span<Box> regions, std::string_view debug_path, KConfig config, std::vector<LayoutRegion>* bboxes = nullptr, int n_threads = 0) -> mln::image2d<Label>;
+
+  /// \brief Same as WSLineExtraction() but the label type is chosen from the number of lines: 16-bit labels if they
+  /// fit, 32-bit labels otherwise (twice the memory, only for very large or stitched pages)
+  auto WSLineExtractionAnyLabel(const mln::image2d<uint8_t>& input, std::span<Box> regions, std::string_view debug_path, KConfig config, std::vector<LayoutRegion>* bboxes = nullptr, int n_threads = 0) -> mln::ndbuffer_image;
 
   /// \brief
   /// \param region The text block
   /// \param lines The lines in the text block
+  /// \param model The classifier of the lines (see EntryModel.hpp). The default model is compiled in when null.
   /// \return A vector that maps (line number) -> 1 if it starts an entry, 0 otherwise
-  void EntryExtraction(Box region, std::span<LayoutRegion> lines, std::vector<LayoutRegion>& out);
+  void EntryExtraction(Box region, std::span<LayoutRegion> lines, std::vector<LayoutRegion>& out,
+                       const EntryModel* model = nullptr);
+
+  /// \brief Batched version of EntryExtraction() over all the text blocks of a page
+  /// \param lines The lines of all the text blocks, grouped by text block (consecutive lines with the same parent_id)
+  /// \param out The region list where the parent_id of the lines refer to. The entries are appended to it.
+  void EntryExtraction(std::span<LayoutRegion> lines, std::vector<LayoutRegion>& out, const EntryModel* model = nullptr);
+
+  enum class OCRLevel
+  {
+    LINE,
+    WORD,
+  };
+
+  /// \brief A line or a word recognized by the OCR
+  struct OCRBox
+  {
+    int         region_id;  // Index of the region in the input of TesseractTextExtraction()
+    OCRLevel    level;
+    Box         bbox;       // In page coordinates
+    float       confidence; // In [0, 100]
+    std::string text;
+  };
 
   /// \brief
+  /// \param boxes If not null, the lines and the words of the regions, grouped by region (in order). Each line is
+  /// followed by its words.
   auto TesseractTextExtraction(const mln::image2d<uint8_t>& input, std::span<Box> regions,
-                               bool is_line = false) -> std::vector<std::string>;
+                               bool is_line = false, std::vector<OCRBox>* boxes = nullptr) -> std::vector<std::string>;
 
 } // namespace scribo
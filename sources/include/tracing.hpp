@@ -0,0 +1,83 @@
+#pragma once
+
+#include <mln/core/trace.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+
+
+/// \brief Tracing of the pipeline stages
+///
+/// The stages open scoped spans (see scribo_entering) that are recorded, when tracing is enabled, in a per-thread
+/// buffer (no lock on the recording path) with their thread, start/end timestamps and the size of the processed
+/// image. When tracing is disabled, a span costs a relaxed atomic load.
+///
+/// The spans are exported as a Chrome trace (JSON), to be opened in chrome://tracing or https://ui.perfetto.dev.
+namespace scribo::trace
+{
+  namespace details
+  {
+    inline std::atomic<bool> g_enabled = false;
+
+    std::int64_t now() noexcept;
+    void         record(const char* name, std::int64_t begin, std::int64_t end, int width, int height) noexcept;
+  } // namespace details
+
+
+  /// Start (or stop) the recording of the spans
+  void enable(bool on = true) noexcept;
+  inline bool is_enabled() noexcept { return details::g_enabled.load(std::memory_order_relaxed); }
+
+  /// Current time (in ns) on the trace clock
+  inline std::int64_t now() noexcept { return details::now(); }
+
+  /// \brief Export the spans started at or after `since` (see now()) as a Chrome trace
+  ///
+  /// It can be called while spans are being recorded (the spans not completed are not exported).
+  void write_chrome_trace(std::ostream& os, std::int64_t since = 0);
+
+  /// \brief Free the recorded spans. No traced code must be running.
+  ///
+  /// The buffers of the threads that have exited are then reused by the new threads (with their trace thread id).
+  void clear();
+
+
+  /// A span recorded from its construction to its destruction (if tracing was enabled at its construction)
+  class scoped_span
+  {
+  public:
+    explicit scoped_span(const char* name, int width = 0, int height = 0) noexcept
+    {
+      if (!is_enabled())
+        return;
+      m_name   = name;
+      m_width  = width;
+      m_height = height;
+      m_begin  = details::now();
+    }
+
+    ~scoped_span()
+    {
+      if (m_name)
+        details::record(m_name, m_begin, details::now(), m_width, m_height);
+    }
+
+    scoped_span(const scoped_span&)            = delete;
+    scoped_span& operator=(const scoped_span&) = delete;
+
+  private:
+    const char*  m_name = nullptr; // Must be a literal (not copied)
+    int          m_width  = 0;
+    int          m_height = 0;
+    std::int64_t m_begin  = 0;
+  };
+} // namespace scribo::trace
+
+
+/// \brief Trace the current scope with pylene's tracer and scribo's one (with the optional size of the processed image)
+///
+///     scribo_entering("scribo::resize", input.width(), input.height());
+#define scribo_entering(NAME, ...)                                                                                     \
+  mln_entering(NAME);                                                                                                  \
+  ::scribo::trace::scoped_span scribo_trace_span_(NAME __VA_OPT__(, ) __VA_ARGS__)
@@ -4,7 +4,10 @@
 #include <spdlog/spdlog.h>
 #include <algorithm>
 #include <span>
+#include <stdexcept>
 #include "scribo.hpp"
+#include "EntryModel.hpp"
+#include "tracing.hpp"
 
 namespace
 {
@@ -70,124 +73,69 @@ namespace
   */
 
 
-  float classify_0(float lspace_abs, float grad, float prspace)
-  {
-  if (prspace <= 0.050192078575491905) {
-    if (grad <= 7.0) {
-      if (lspace_abs <= 5.0) {
-        return 0.2806137080585029;
-      } else /* (lspace_abs > 5.0) */ {
-        return 0.009406046080173251;
-      }
-    } else /* (grad > 7.0) */ {
-      if (prspace <= 0.023809523321688175) {
-        return 0.5186166688750498;
-      } else /* (prspace > 0.023809523321688175) */ {
-        return 0.8073099294583558;
-      }
-    }
-  } else /* (prspace > 0.050192078575491905) */ {
-    if (lspace_abs <= 15.0) {
-      return 0.9956150117952923;
-    } else /* (lspace_abs > 15.0) */ {
-      if (grad <= 6.0) {
-        return 0.287751801205705;
-      } else /* (grad > 6.0) */ {
-        if (grad <= 17.0) {
-          return 0.8895712641566001;
-        } else /* (grad > 17.0) */ {
-          return 0.5709700948212982;
-        }
-      }
-    }
-  }
-  }
-
-  float classify_1(float lspace_abs, float grad, float prspace)
-  {
-  if (grad <= 5.0) {
-    if (prspace <= 0.015286649111658335) {
-      if (lspace_abs <= 1.0) {
-        if (prspace <= 0.0012019231216982007) {
-          return 0.23448713324461126;
-        } else /* (prspace > 0.0012019231216982007) */ {
-          return 0.5701066700938181;
-        }
-      } else /* (lspace_abs > 1.0) */ {
-        return 0.7509394870522096;
-      }
-    } else /* (prspace > 0.015286649111658335) */ {
-      if (lspace_abs <= 15.0) {
-        return 0.9902016678266132;
-      } else /* (lspace_abs > 15.0) */ {
-        if (prspace <= 0.05302507430315018) {
-          return 0.3559050064184852;
-        } else /* (prspace > 0.05302507430315018) */ {
-          return 0.9729120552826217;
-        }
-      }
-    }
-  } else /* (grad > 5.0) */ {
-    if (prspace <= 0.05557460896670818) {
-      return 0.00886907320584195;
-    } else /* (prspace > 0.05557460896670818) */ {
-      return 0.8568592722907037;
-    }
-  }
-  }
-
-  void entry_predictor(const float* lm, const float* rm, float colwidth, std::size_t n, uint8_t* out)
+  // 2-state Viterbi over the lines of a column. Only the last probabilities are kept; `from` is a caller-provided
+  // buffer of 2n backpointers so that a batch of columns runs without any allocation.
+  // The model is either a scribo::EntryModel or a scribo::static_entry_model.
+  template <class Model>
+  void entry_predictor(const Model& model, const float* lm, const float* rm, float colwidth, std::size_t n,
+                       uint8_t* from_, uint8_t* out)
   {
     if (n == 0)
       return;
 
-
-    std::vector<float>    proba_(2 * n);
-    std::vector<uint8_t>  from_(2 * n);
-
-
-    float*   proba[2] = {proba_.data(), proba_.data() + n};
-    uint8_t* from[2]  = {from_.data(), from_.data() + n};
-
-
-    proba[0][0] = 0.5f;
-    proba[1][0] = 0.5f;
+    uint8_t* from[2] = {from_, from_ + n};
+    float    proba[2] = {0.5f, 0.5f};
 
     for (std::size_t i = 1; i < n; ++i)
     {
-      float lspace_abs = lm[i];
-      float grad       = std::abs(lm[i] - lm[i - 1]);
-      float prspace    = rm[i - 1] / colwidth;
+      float x[scribo::kEntryFeatureCount];
+      x[scribo::kEntryLeftSpace]      = lm[i];
+      x[scribo::kEntryLeftSpaceGrad]  = std::abs(lm[i] - lm[i - 1]);
+      x[scribo::kEntryPrevRightSpace] = rm[i - 1] / colwidth;
 
-      float p[2] = {
-        classify_0(lspace_abs, grad, prspace),
-        classify_1(lspace_abs, grad, prspace)
-      };
+      float p[2];
+      model.predict(x, p);
 
+      float next[2];
       {
-        float a = proba[0][i - 1] * p[0];
-        float b = proba[1][i - 1] * p[1];
+        float a = proba[0] * p[0];
+        float b = proba[1] * p[1];
         from[1][i] = a > b ? 0 : 1;
-        proba[1][i] = a > b ? a : b;
+        next[1] = a > b ? a : b;
       }
       {
-        float a = proba[0][i - 1] * (1-p[0]);
-        float b = proba[1][i - 1] * (1-p[1]);
-        from[0][i]  = a > b ? 0 : 1;
-        proba[0][i] = a > b ? a : b;
+        float a = proba[0] * (1-p[0]);
+        float b = proba[1] * (1-p[1]);
+        from[0][i] = a > b ? 0 : 1;
+        next[0] = a > b ? a : b;
       }
+      proba[0] = next[0];
+      proba[1] = next[1];
     }
 
-    int lbl = proba[0][n - 1] > proba[1][n - 1] ? 0 : 1;
+    int lbl = proba[0] > proba[1] ? 0 : 1;
     for (std::size_t i = n - 1; i > 0; --i)
     {
       out[i] = lbl;
-      spdlog::debug("Prediction for line {} is {} (p={})", i, lbl, proba[lbl][i]);
+      spdlog::debug("Prediction for line {} is {}", i, lbl);
       lbl = from[lbl][i];
     }
     out[0] =  lbl;
   }
 
+  // Left and right margins of the lines wrt the column
+  void compute_features(Box region, std::span<const scribo::LayoutRegion> lines, float* lm, float* rm)
+  {
+    int xmin = region.x;
+    int xmax = region.x1();
+    for (std::size_t i = 0; i < lines.size(); ++i)
+    {
+      auto r = lines[i].bbox;
+      lm[i]  = (r.x - xmin);
+      rm[i]  = (xmax - r.x1());
+    }
+  }
+
   void add_new_elements(std::span<uint8_t> is_entry_start, std::span<scribo::LayoutRegion> lines, std::vector<scribo::LayoutRegion>& out)
   {
     int n = (int)is_entry_start.size();
@@ -213,6 +161,40 @@ namespace
     }
   }
 
+  // Reserve the room for `nentries` new entries in `out`. If the lines live in `out`, the span is rebound after the
+  // reallocation.
+  std::span<scribo::LayoutRegion> reserve_entries(std::span<scribo::LayoutRegion> lines,
+                                                  std::vector<scribo::LayoutRegion>& out, std::size_t nentries)
+  {
+    if (out.data() <= lines.data() && lines.data() < (out.data() + out.size()))
+    {
+      auto pos = lines.data() - out.data();
+      out.reserve(out.size() + nentries);
+      return std::span(out.data() + pos, lines.size());
+    }
+    out.reserve(out.size() + nentries);
+    return lines;
+  }
+
+  // Buffers of the entry extraction (structure of arrays over the lines), reused between the calls of a thread
+  struct entry_buffers
+  {
+    std::vector<float>   lm;
+    std::vector<float>   rm;
+    std::vector<uint8_t> is_entry_start;
+    std::vector<uint8_t> from;
+
+    static entry_buffers& get(std::size_t nlines)
+    {
+      thread_local entry_buffers buf;
+      buf.lm.resize(nlines);
+      buf.rm.resize(nlines);
+      buf.is_entry_start.assign(nlines, false);
+      buf.from.resize(2 * nlines);
+      return buf;
+    }
+  };
+
 } // namespace
 
 
@@ -220,38 +202,80 @@ namespace scribo
 {
 
 
-  void EntryExtraction(Box region, std::span<scribo::LayoutRegion> lines, std::vector<scribo::LayoutRegion>& out)
+  void EntryExtraction(Box region, std::span<scribo::LayoutRegion> lines, std::vector<scribo::LayoutRegion>& out,
+                       const EntryModel* model)
   {
-    int ymin   = region.y;
-    int xmin   = region.x;
-    int xmax   = region.x1();
+    spdlog::debug("Start column x={}--{} y={} indent detection", region.x, region.x1(), region.y);
 
-    spdlog::debug("Start column x={}--{} y={} indent detection", xmin, xmax, ymin);
+    std::size_t nlines = lines.size();
+    if (nlines == 0)
+      return;
 
-    if (out.data() <= lines.data() && lines.data() < (out.data() + out.size()))
-    {
-      if (out.capacity() - out.size() < lines.size())
-        spdlog::error("Aliasing detected. Allocation may occur and causes invalidated data.");
-    }
+    auto& [lm, rm, is_entry_start, from] = entry_buffers::get(nlines);
+
+    compute_features(region, lines, lm.data(), rm.data());
+    if (model)
+      entry_predictor(*model, lm.data(), rm.data(), region.width, nlines, from.data(), is_entry_start.data());
+    else
+      entry_predictor(scribo::default_entry_model{}, lm.data(), rm.data(), region.width, nlines, from.data(),
+                      is_entry_start.data());
+    is_entry_start[0] = true;
+
+    lines = reserve_entries(lines, out, std::ranges::count(is_entry_start, true));
+    add_new_elements(is_entry_start, lines, out);
+  }
+
+
+  void EntryExtraction(std::span<scribo::LayoutRegion> lines, std::vector<scribo::LayoutRegion>& out,
+                       const EntryModel* model)
+  {
+    scribo_entering("scribo::EntryExtraction");
+    std::size_t nlines = lines.size();
+    if (nlines == 0)
+      return;
 
-    std::size_t                 nlines = lines.size();
-    std::vector<uint8_t>        is_entry_start(nlines, false);
+    // Structure of arrays for all the columns: the lines of the k-th column are in [offsets[k], offsets[k+1])
+    std::vector<int> offsets;
+    auto& [lm, rm, is_entry_start, from] = entry_buffers::get(nlines);
 
-    // Compute the features
-    std::vector<float>       feat_buffer_1((nlines + 4), 0); // 2 rows for padding
-    std::vector<float>       feat_buffer_2((nlines + 4), 0); // 2 rows for padding
+    for (std::size_t i = 0; i < nlines; ++i)
+      if (i == 0 || lines[i].parent_id != lines[i - 1].parent_id)
+        offsets.push_back(i);
+    offsets.push_back(nlines);
 
-    int colwidth = region.width;
-    int i        = 2;
-    for (const auto& l : lines)
+    int ncols = (int)offsets.size() - 1;
+    for (int k = 0; k < ncols; ++k)
     {
-      auto r = l.bbox;
-      feat_buffer_1[i] = (r.x - xmin);    // float(colwidth);
-      feat_buffer_2[i] = (xmax - r.x1()); // float(colwidth);
-      i += 1;
+      int q = lines[offsets[k]].parent_id;
+      if (q < 0 || q >= (int)out.size())
+      {
+        spdlog::error("Invalid parent region {} for a line.", q);
+        throw std::runtime_error("Invalid parent region for a line.");
+      }
+
+      Box  region = out[q].bbox;
+      int  b      = offsets[k];
+      int  n      = offsets[k + 1] - b;
+      spdlog::debug("Start column x={}--{} y={} indent detection", region.x, region.x1(), region.y);
+
+      compute_features(region, lines.subspan(b, n), lm.data() + b, rm.data() + b);
+      if (model)
+        entry_predictor(*model, lm.data() + b, rm.data() + b, region.width, n, from.data() + 2 * b,
+                        is_entry_start.data() + b);
+      else
+        entry_predictor(scribo::default_entry_model{}, lm.data() + b, rm.data() + b, region.width, n,
+                        from.data() + 2 * b, is_entry_start.data() + b);
+      is_entry_start[b] = true;
     }
 
-    entry_predictor(feat_buffer_1.data() + 2, feat_buffer_2.data() + 2, colwidth, nlines, is_entry_start.data());
-    add_new_elements(is_entry_start, lines, out);
+    // Reserve the entries at once
+    lines = reserve_entries(lines, out, std::ranges::count(is_entry_start, true));
+
+    for (int k = 0; k < ncols; ++k)
+    {
+      int b = offsets[k];
+      int n = offsets[k + 1] - b;
+      add_new_elements(std::span(is_entry_start).subspan(b, n), lines.subspan(b, n), out);
+    }
   }
 }
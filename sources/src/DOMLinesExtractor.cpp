@@ -1,7 +1,7 @@
 #include "scribo.hpp"
+#include "tracing.hpp"
 
 #include <mln/core/image/ndimage.hpp>
-#include <mln/core/image/view/operators.hpp>
 #include <mln/core/neighborhood/c4.hpp>
 #include <mln/core/se/periodic_line2d.hpp>
 #include <mln/core/se/rect2d.hpp>
@@ -23,7 +23,12 @@
 #include "watershed.hpp"
 
 
+#include <atomic>
+#include <future>
+#include <limits>
+#include <numeric>
 #include <span>
+#include <thread>
 
 namespace
 {
@@ -134,81 +139,100 @@ namespace
   };
 
 
-  void compute_line_bboxes(mln::image2d<uint8_t> input, mln::image2d<int16_t> ws, mln::box2d region, int nlabel, std::vector<scribo::LayoutRegion>* out, int parent_id, KConfig config)
+  // Compute the bounding boxes of the lines of all the regions with a single pass over the watershed image.
+  // The labels of the i-th region are in (offsets[i], offsets[i+1]]. The lines of a region that are closer than the
+  // x-height are merged (and relabeled in ws).
+  template <class Label>
+  void compute_line_bboxes(const mln::image2d<uint8_t>& input, mln::image2d<Label>& ws, std::span<const int> offsets,
+                           std::vector<scribo::LayoutRegion>* out, KConfig config)
   {
-    using mln::box2d;
-    using namespace mln::view::ops;
+    const int nlabel = offsets.back();
 
+    // 1. Accumulate the black pixels of every label
+    std::vector<bbox> attr(nlabel + 1);
+    {
+      const mln::box2d domain = ws.domain();
+      for (int y = 0; y < domain.height(); ++y)
+      {
+        const uint8_t* in  = input.buffer() + y * input.stride();
+        const Label*   lbl = ws.buffer() + y * ws.stride();
+        for (int x = 0; x < domain.width(); ++x)
+          if (lbl[x] > 0 && in[x] < config.kLayoutWhiteLevel)
+            attr[lbl[x]].take(mln::point2d{domain.x() + x, domain.y() + y});
+      }
+    }
 
-    // const float kLineVerticalSigma = (kLineHeight / 2.f) / 10.f;
-    // const float kLineHorizontalSigma = (kWordWidth / 2.f);
-    input = input.clip(region);
-    ws     = ws.clip(region);
-
-    auto tmp   = mln::view::ifelse(input < config.kLayoutWhiteLevel, ws, int16_t(0));
-    auto attr = mln::labeling::accumulate(tmp, nlabel, bbox{});
-
-    // Remove regions on the same line
-    std::vector<int> labels(nlabel);
-    std::iota(labels.begin(), labels.end(), 1);
-    auto subrange = std::ranges::stable_partition(labels, [&attr](int i) { return attr[i].box().empty();});
+    // 2. Group the lines of each region (only the small label table is visited)
+    std::vector<Label> newlabels(nlabel + 1);
+    std::iota(newlabels.begin(), newlabels.end(), 0);
+    bool has_merge = false;
 
+    for (int region_id = 0; region_id + 1 < (int)offsets.size(); ++region_id)
+    {
+      // Remove regions on the same line
+      std::vector<int> labels(offsets[region_id + 1] - offsets[region_id]);
+      std::iota(labels.begin(), labels.end(), offsets[region_id] + 1);
+      auto subrange = std::ranges::stable_partition(labels, [&attr](int i) { return attr[i].box().empty();});
 
-    if (subrange.empty())
-      return;
+      if (subrange.empty())
+        continue;
 
-    std::ranges::stable_sort(subrange, std::ranges::less{}, [&attr](int i) { return attr[i].get_mc_y(); });
+      std::ranges::stable_sort(subrange, std::ranges::less{}, [&attr](int i) { return attr[i].get_mc_y(); });
 
-    std::vector<int16_t> newlabels(nlabel+1);
-    std::iota(newlabels.begin(), newlabels.end(), 0);
-
-    int prev = subrange[0];
-    float a = attr[prev].get_mc_y();
-    for (std::size_t k = 1; k < subrange.size(); ++k)
-    {
-      int cur = subrange[k];
-      float b = attr[cur].get_mc_y();
-      if ((b - a) < config.kxheight)
-      {
-        attr[prev].take(attr[cur]);
-        attr[cur].init();
-        newlabels[cur] = prev;
-      }
-      else
+      int prev = subrange[0];
+      float a = attr[prev].get_mc_y();
+      for (std::size_t k = 1; k < subrange.size(); ++k)
       {
-        a = b;
-        prev = cur;
+        int cur = subrange[k];
+        float b = attr[cur].get_mc_y();
+        if ((b - a) < config.kxheight)
+        {
+          attr[prev].take(attr[cur]);
+          attr[cur].init();
+          newlabels[cur] = prev;
+          has_merge = true;
+        }
+        else
+        {
+          a = b;
+          prev = cur;
+        }
       }
-    }
-
-    mln::for_each(ws, [&newlabels] (int16_t& v){ v = newlabels[v]; });
 
-    for (auto i : subrange)
-    {
-      auto b = attr[i].box();
-      if (!b.empty())
+      for (auto i : subrange)
       {
-        scribo::LayoutRegion r;
-        r.bbox        = {b.x(), b.y(), b.width(), b.height()};
-        r.parent_id   = parent_id;
-        r.type        = DOMCategory::LINE;
-        r.mask_instance_id = i;
-        out->push_back(r);
+        auto b = attr[i].box();
+        if (!b.empty())
+        {
+          scribo::LayoutRegion r;
+          r.bbox        = {b.x(), b.y(), b.width(), b.height()};
+          r.parent_id   = region_id;
+          r.type        = DOMCategory::LINE;
+          r.mask_instance_id = i;
+          out->push_back(r);
+        }
       }
     }
 
+    // 3. Relabel the merged lines
+    if (has_merge)
+      mln::for_each(ws, [&newlabels] (Label& v){ v = newlabels[v]; });
   }
 
 
-  void blur_region_and_labelize(const mln::image2d<uint8_t>& in, mln::box2d region, mln::image2d<uint8_t>& output, KConfig config)
+  // Blur the region and keep a single minimum per line
+  // Returns an image whose domain is the region
+  mln::image2d<uint8_t> blur_region_and_labelize(const mln::image2d<uint8_t>& in, mln::box2d region, KConfig config,
+                                                 std::vector<float>& scratch)
   {
     const float kLineVerticalSigma   = config.kLineHeight * 0.1f;
     const float kLineHorizontalSigma = config.kWordWidth * 0.3f;
     const int kWhiteLevelForLineSplit = 230;
 
-    auto out = output.clip(region);
+    mln::image2d<uint8_t> out;
+    out.resize(region);
     mln::copy(in.clip(region), out);
-    gaussian2d(out, kLineHorizontalSigma, kLineVerticalSigma, 255);
+    gaussian2d(out, kLineHorizontalSigma, kLineVerticalSigma, 255, scratch);
 
     auto r   = mln::se::rect2d(static_cast<int>(2.0f * config.kOneEm + 0.5f),
                                static_cast<int>(0.5f * config.kxheight + 0.5f));
@@ -241,57 +265,127 @@ namespace
       //mln::io::imsave(markers, "markers.tiff");
 
       clo = mln::morpho::closing_by_reconstruction(clo, markers, mln::c4);
-      mln::copy(clo, out);
     }
+    return clo;
   }
-}
 
+  // The watershed of a region is labeled on 32 bits (it is small and temporary), the page labels may use 16 bits
+  struct region_watershed
+  {
+    mln::image2d<uint8_t> blurred; // Only kept for debugging
+    mln::image2d<int32_t> labels;
+    int                   nlabel = 0;
+  };
 
+  // Blur and watershed every region on a pool of threads, each thread reuses its own scratch buffer
+  std::vector<region_watershed> watershed_regions(const mln::image2d<uint8_t>& input, std::span<Box> regions,
+                                                  KConfig config, bool keep_blurred, int n_threads)
+  {
+    std::vector<region_watershed> results(regions.size());
+    std::atomic<int>              next = 0;
 
-namespace scribo
-{
-  mln::image2d<int16_t> WSLineExtraction(const mln::image2d<uint8_t>& input, std::span<Box> regions, std::string_view debug_path, KConfig config, std::vector<scribo::LayoutRegion>* bboxes)
+    auto worker = [&]() {
+      std::vector<float> scratch;
+      for (int i = next++; i < (int)regions.size(); i = next++)
+      {
+        const auto& r      = regions[i];
+        mln::box2d  region = {r.x, r.y, r.width, r.height};
+        auto        tmp    = blur_region_and_labelize(input, region, config, scratch);
+
+        results[i].labels = impl::watershed<int32_t>(tmp, mln::c4, results[i].nlabel);
+        if (keep_blurred)
+          results[i].blurred = std::move(tmp);
+      }
+    };
+
+    if (n_threads <= 0)
+      n_threads = std::max(1u, std::thread::hardware_concurrency());
+    int n_workers = std::min<int>(n_threads, regions.size());
+    std::vector<std::future<void>> tasks;
+    for (int k = 1; k < n_workers; ++k)
+      tasks.push_back(std::async(std::launch::async, worker));
+    worker();
+    for (auto& t : tasks)
+      t.get();
+    return results;
+  }
+
+  // Copy the labels of a region in the page labels, shifted by offset (watershed lines stay 0)
+  template <class Label>
+  void paste_labels(const mln::image2d<int32_t>& labels, int offset, mln::image2d<Label>& ws)
+  {
+    auto region = labels.domain();
+    auto out    = ws.clip(region);
+    for (int y = 0; y < region.height(); ++y)
+    {
+      const int32_t* src = labels.buffer() + y * labels.stride();
+      Label*         dst = out.buffer() + y * out.stride();
+      for (int x = 0; x < region.width(); ++x)
+        dst[x] = (src[x] > 0) ? static_cast<Label>(src[x] + offset) : Label(0);
+    }
+  }
+
+  struct line_watershed
+  {
+    std::vector<region_watershed> regions;
+    std::vector<int>              offsets; // The labels of the i-th region are in (offsets[i], offsets[i+1]]
+  };
+
+  // Blur and watershed every region, the number of labels is offsets.back()
+  line_watershed watershed_lines(const mln::image2d<uint8_t>& input, std::span<Box> regions, std::string_view debug_path,
+                                 KConfig config, int n_threads)
   {
     using mln::point2d;
 
     // Opening with a horizontal SE to give matters to letters (merge letter/words but not lines)
-    mln::image2d<uint8_t> f;
+    if (!debug_path.empty())
     {
       mln::se::periodic_line2d l(point2d{1, 0}, config.kLayoutBlockOpeningWidth / 2);
-      f = mln::morpho::opening(input, l);
-
-      if (!debug_path.empty())
-        mln::io::imsave(f, fmt::format("{}-00-input.tiff", debug_path));
+      auto f = mln::morpho::opening(input, l);
+      mln::io::imsave(f, fmt::format("{}-00-input.tiff", debug_path));
     }
 
-    mln::image2d<uint8_t> blurred;
-    mln::resize(blurred, f).set_init_value(uint8_t(255));
-
-
-
-    // 1. Blur the image in columns only and prepare WS markers
-    for (auto r : regions)
-      blur_region_and_labelize(input, mln::box2d{r.x, r.y, r.width, r.height}, blurred, config);
+    // 1. Blur each region in columns only and prepare WS markers
+    // 2. Watershed on the region only (regions are processed concurrently)
+    line_watershed ws;
+    ws.regions = watershed_regions(input, regions, config, !debug_path.empty(), n_threads);
+    ws.offsets = {0};
+    for (const auto& res : ws.regions)
+      ws.offsets.push_back(ws.offsets.back() + res.nlabel);
 
     if (!debug_path.empty())
+    {
+      mln::image2d<uint8_t> blurred;
+      mln::resize(blurred, input).set_init_value(uint8_t(255));
+      for (const auto& res : ws.regions)
+        mln::copy(res.blurred, blurred.clip(res.blurred.domain()));
       mln::io::imsave(blurred, fmt::format("{}-01-blurred.tiff", debug_path));
+    }
+    return ws;
+  }
 
-    //impl::watershed(blurred, mln::c4, markers, nlabel);
-    int nlabel;
-    auto ws = mln::morpho::watershed<int16_t>(blurred, mln::c4, nlabel);
+  // Merge the region labels in a page label image and compute the line boxes
+  template <class Label>
+  mln::image2d<Label> merge_lines(const mln::image2d<uint8_t>& input, const line_watershed& lws,
+                                  std::string_view debug_path, KConfig config, std::vector<scribo::LayoutRegion>* bboxes)
+  {
+    const int nlabel = lws.offsets.back();
+
+    // 3. Merge the labels, the labels of a region follow the ones of the previous regions
+    mln::image2d<Label> ws;
+    mln::resize(ws, input).set_init_value(Label(0));
+    for (std::size_t i = 0; i < lws.regions.size(); ++i)
+      paste_labels(lws.regions[i].labels, lws.offsets[i], ws);
 
-    //auto ws = markers;
+    spdlog::debug("Line extraction: {} labels stored on {} bits ({:.1f} MB)", nlabel, 8 * sizeof(Label),
+                  double(ws.width()) * ws.height() * sizeof(Label) / (1 << 20));
 
     // 4. Compute the bounding box and insert lines
     {
       if (bboxes)
       {
         bboxes->clear();
-        for (int i = 0; i < (int)regions.size(); ++i)
-        {
-          const auto& r = regions[i];
-          compute_line_bboxes(input, ws, mln::box2d{r.x, r.y, r.width, r.height}, nlabel, bboxes, i, config);
-        }
+        compute_line_bboxes(input, ws, lws.offsets, bboxes, config);
         if ((int)bboxes->size() != nlabel)
           spdlog::warn("Invalid number of between WS (={}) and output (={}). A layout error is likely.", nlabel, bboxes->size());
       }
@@ -302,6 +396,34 @@ namespace scribo
 
     return ws;
   }
+}
+
+
+
+namespace scribo
+{
+  template <class Label>
+  mln::image2d<Label> WSLineExtraction(const mln::image2d<uint8_t>& input, std::span<Box> regions, std::string_view debug_path, KConfig config, std::vector<scribo::LayoutRegion>* bboxes, int n_threads)
+  {
+    scribo_entering("scribo::WSLineExtraction", input.width(), input.height());
+    auto lws = watershed_lines(input, regions, debug_path, config, n_threads);
+    if (lws.offsets.back() > std::numeric_limits<Label>::max())
+    {
+      spdlog::error("Too many lines ({}) for {}-bit labels.", lws.offsets.back(), 8 * sizeof(Label));
+      throw std::runtime_error("Label overflow in line extraction.");
+    }
+    return merge_lines<Label>(input, lws, debug_path, config, bboxes);
+  }
 
+  mln::ndbuffer_image WSLineExtractionAnyLabel(const mln::image2d<uint8_t>& input, std::span<Box> regions, std::string_view debug_path, KConfig config, std::vector<scribo::LayoutRegion>* bboxes, int n_threads)
+  {
+    scribo_entering("scribo::WSLineExtraction", input.width(), input.height());
+    auto lws = watershed_lines(input, regions, debug_path, config, n_threads);
+    if (lws.offsets.back() <= std::numeric_limits<int16_t>::max())
+      return merge_lines<int16_t>(input, lws, debug_path, config, bboxes);
+    return merge_lines<int32_t>(input, lws, debug_path, config, bboxes);
+  }
 
+  template mln::image2d<int16_t> WSLineExtraction<int16_t>(const mln::image2d<uint8_t>&, std::span<Box>, std::string_view, KConfig, std::vector<scribo::LayoutRegion>*, int);
+  template mln::image2d<int32_t> WSLineExtraction<int32_t>(const mln::image2d<uint8_t>&, std::span<Box>, std::string_view, KConfig, std::vector<scribo::LayoutRegion>*, int);
 } // namespace scribo
@@ -0,0 +1,144 @@
+#include "EntryModel.hpp"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+using json = nlohmann::json;
+
+namespace scribo
+{
+
+  EntryModel::EntryModel()
+  {
+    add_tree(0, kDefaultEntryTree0);
+    add_tree(1, kDefaultEntryTree1);
+  }
+
+  void EntryModel::clear()
+  {
+    m_feature.clear();
+    m_threshold.clear();
+    m_leaves.clear();
+    for (auto& c : m_classifiers)
+      c = ensemble{};
+  }
+
+  void EntryModel::add_tree(int state, std::span<const tree_node> nodes)
+  {
+    // Check the tree before any recursion on it
+    int n = (int)nodes.size();
+    if (n == 0)
+      throw std::runtime_error("Invalid entry model (empty tree).");
+
+    std::vector<int> nparents(n, 0);
+    for (const auto& node : nodes)
+    {
+      if (node.left < 0)
+        continue;
+      if (node.left >= n || node.right < 0 || node.right >= n || node.feature < 0 || node.feature >= kEntryFeatureCount)
+        throw std::runtime_error("Invalid entry model (bad node).");
+      nparents[node.left]++;
+      nparents[node.right]++;
+    }
+    if (nparents[0] != 0 || std::ranges::any_of(nparents.begin() + 1, nparents.end(), [](int k) { return k != 1; }))
+      throw std::runtime_error("Invalid entry model (the nodes do not form a tree).");
+
+    int depth = details::tree_depth(nodes);
+    if (depth > 16)
+      throw std::runtime_error("Invalid entry model (tree too deep).");
+
+    tree_header h;
+    h.depth       = depth;
+    h.node_offset = (int)m_feature.size();
+    h.leaf_offset = (int)m_leaves.size();
+
+    m_feature.resize(m_feature.size() + (1 << depth) - 1);
+    m_threshold.resize(m_threshold.size() + (1 << depth) - 1);
+    m_leaves.resize(m_leaves.size() + (1 << depth));
+    details::flatten_tree(nodes, 0, 0, 0, depth, m_feature.data() + h.node_offset, m_threshold.data() + h.node_offset,
+                          m_leaves.data() + h.leaf_offset);
+
+    m_classifiers[state].trees.push_back(h);
+  }
+
+  void EntryModel::predict(const float* x, float* p) const
+  {
+    for (int k = 0; k < 2; ++k)
+    {
+      const auto& c = m_classifiers[k];
+      float       v = c.base_score;
+      for (const auto& t : c.trees)
+        v += details::eval_flat_tree(m_feature.data() + t.node_offset, m_threshold.data() + t.node_offset,
+                                     m_leaves.data() + t.leaf_offset, t.depth, x);
+      p[k] = c.sigmoid ? 1 / (1 + std::exp(-v)) : v;
+    }
+  }
+
+  EntryModel EntryModel::load(std::istream& is)
+  {
+    EntryModel model;
+    model.clear();
+
+    try
+    {
+      json doc = json::parse(is);
+
+      const auto& classifiers = doc.at("classifiers");
+      if (classifiers.size() != 2)
+        throw std::runtime_error("Invalid entry model (2 classifiers expected).");
+
+      for (int k = 0; k < 2; ++k)
+      {
+        const auto& c = classifiers[k];
+        auto        link = c.value("link", std::string("identity"));
+        if (link != "identity" && link != "sigmoid")
+          throw std::runtime_error("Invalid entry model (unknown link function).");
+
+        model.m_classifiers[k].base_score = c.value("base_score", 0.f);
+        model.m_classifiers[k].sigmoid    = (link == "sigmoid");
+
+        for (const auto& t : c.at("trees"))
+        {
+          auto left      = t.at("children_left").get<std::vector<int>>();
+          auto right     = t.at("children_right").get<std::vector<int>>();
+          auto feature   = t.at("feature").get<std::vector<int>>();
+          auto threshold = t.at("threshold").get<std::vector<double>>();
+          auto value     = t.at("value").get<std::vector<float>>();
+
+          std::size_t n = left.size();
+          if (right.size() != n || feature.size() != n || threshold.size() != n || value.size() != n)
+            throw std::runtime_error("Invalid entry model (inconsistent tree arrays).");
+
+          std::vector<tree_node> nodes(n);
+          for (std::size_t i = 0; i < n; ++i)
+            nodes[i] = {left[i], right[i], feature[i], threshold[i], value[i]};
+          model.add_tree(k, nodes);
+        }
+      }
+    }
+    catch (const json::exception& e)
+    {
+      spdlog::error("Unable to parse the entry model ({}).", e.what());
+      throw std::runtime_error("Invalid entry model.");
+    }
+    return model;
+  }
+
+  EntryModel EntryModel::load(const std::string& path)
+  {
+    std::ifstream f(path);
+    if (!f)
+    {
+      spdlog::error("Unable to open the entry model '{}'.", path);
+      throw std::runtime_error("Unable to open the entry model.");
+    }
+    spdlog::info("Loading the entry model '{}'.", path);
+    return load(f);
+  }
+
+} // namespace scribo
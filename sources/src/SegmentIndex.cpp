@@ -0,0 +1,26 @@
+#include "SegmentIndex.hpp"
+#include <algorithm>
+#include <vector>
+
+
+SegmentIndex::SegmentIndex(std::span<const Segment> segments)
+  : m_segments{segments}
+{
+  std::vector<entry> entries;
+  entries.reserve(segments.size());
+  for (int i = 0; i < (int)segments.size(); ++i)
+  {
+    const auto& s = segments[i];
+    entries.push_back({{std::min(s.start.x, s.end.x), std::min(s.start.y, s.end.y)},
+                       {std::max(s.start.x, s.end.x), std::max(s.start.y, s.end.y)},
+                       i});
+  }
+  m_tree.insert(entries.begin(), entries.end());
+}
+
+int SegmentIndex::count_in(Box region) const
+{
+  int n = 0;
+  for_each_in(region, [&n](const Segment&) { n++; });
+  return n;
+}
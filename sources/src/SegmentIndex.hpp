@@ -0,0 +1,80 @@
+#pragma once
+
+#include <CoreTypes.hpp>
+#include <span>
+
+// THST/allocator.h includes these C headers inside its namespace: they must be included first
+#include <cassert>
+#include <cstdint>
+
+// Third-party header, not warning-clean (false positives of -Wmaybe-uninitialized in the node splits)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <THST/RTree.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+
+/// Spatial index (R-tree) over a set of segments.
+/// The index does not own the segments (they must outlive the index).
+class SegmentIndex
+{
+public:
+  SegmentIndex() = default;
+  explicit SegmentIndex(std::span<const Segment> segments);
+
+  /// Call f(s) for every segment s that lies in the region (i.e. region.has(s) is true)
+  template <class F>
+  void for_each_in(Box region, F&& f) const;
+
+  /// Number of segments in the region
+  int count_in(Box region) const;
+
+  std::size_t size() const { return m_segments.size(); }
+
+private:
+  struct entry
+  {
+    int min[2];
+    int max[2];
+    int id;
+  };
+
+  std::span<const Segment>      m_segments;
+  spatial::RTree<int, entry, 2> m_tree;
+};
+
+
+/******************************************/
+/****          Implementation          ****/
+/******************************************/
+
+template <class F>
+void SegmentIndex::for_each_in(Box region, F&& f) const
+{
+  if (region.empty() || m_segments.empty())
+    return;
+
+  // Output iterator that forwards the found entries to the callback
+  struct visitor
+  {
+    F*             f;
+    const Segment* segments;
+
+    visitor& operator*() { return *this; }
+    visitor& operator++() { return *this; }
+    visitor& operator=(const entry& e)
+    {
+      (*f)(segments[e.id]);
+      return *this;
+    }
+  };
+
+  // Box::has is half-open, the R-tree boxes are closed
+  int pmin[2] = {region.x, region.y};
+  int pmax[2] = {region.x1() - 1, region.y1() - 1};
+  m_tree.query(spatial::contains<2>(pmin, pmax), visitor{&f, m_segments.data()});
+}
@@ -1,56 +1,215 @@
 #include <scribo.hpp>
+#include <tracing.hpp>
 
 #include <spdlog/spdlog.h>
 #include <tesseract/baseapi.h>
+#include <tesseract/resultiterator.h>
 #include <mln/core/image/ndimage.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
 namespace
 {
-  void tesseract_init(tesseract::TessBaseAPI& tess_api, const mln::image2d<uint8_t>& input, bool is_line)
+  // Minimal number of regions handled by an engine (below, the thread is not worth it)
+  constexpr int kMinRegionsPerEngine = 8;
+
+
+  // Engines are expensive to initialize (Init() loads the language model), so they are initialized once and kept in
+  // a process-wide pool. An engine is leased to a single thread at a time. The pool holds at most one engine per core:
+  // when all of them are leased, acquire() waits for one to be released.
+  class tesseract_pool
   {
-    if (tess_api.Init(NULL, "fra"))
+  public:
+    tesseract_pool()
+      : m_max_engines(std::max(1u, std::thread::hardware_concurrency()))
     {
-      spdlog::error("Could not initialize tesseract.");
-      throw std::runtime_error("Could not initialize tesseract");
     }
-    else
+
+    std::unique_ptr<tesseract::TessBaseAPI> acquire()
+    {
+      {
+        std::unique_lock lock(m_mutex);
+        m_cv.wait(lock, [this] { return !m_free.empty() || m_nengines < m_max_engines; });
+        if (!m_free.empty())
+        {
+          auto e = std::move(m_free.back());
+          m_free.pop_back();
+          return e;
+        }
+        m_nengines++; // Reserve the slot, the engine is initialized out of the lock
+      }
+
+      auto e = std::make_unique<tesseract::TessBaseAPI>();
+      if (e->Init(NULL, "fra"))
+      {
+        {
+          std::scoped_lock lock(m_mutex);
+          m_nengines--;
+        }
+        m_cv.notify_one();
+        spdlog::error("Could not initialize tesseract.");
+        throw std::runtime_error("Could not initialize tesseract");
+      }
       spdlog::info("Tesseract has been initialized.");
+      return e;
+    }
 
-    auto seg_mode = tesseract::PSM_SINGLE_BLOCK;
-    if (is_line)
-      seg_mode = tesseract::PSM_SINGLE_LINE;
+    void release(std::unique_ptr<tesseract::TessBaseAPI> e)
+    {
+      e->Clear(); // Free the page and the results, keep the language model
+      {
+        std::scoped_lock lock(m_mutex);
+        m_free.push_back(std::move(e));
+      }
+      m_cv.notify_one();
+    }
 
-    tess_api.SetPageSegMode(seg_mode);
-    tess_api.SetImage(input.buffer(), input.width(), input.height(), input.byte_stride(0), input.byte_stride(1));
-    tess_api.SetSourceResolution(150);
-  }
+  private:
+    std::mutex                                           m_mutex;
+    std::condition_variable                              m_cv;
+    std::vector<std::unique_ptr<tesseract::TessBaseAPI>> m_free;
+    int                                                  m_nengines = 0; // Number of engines (free or leased)
+    const int                                            m_max_engines;
+  };
 
-  void tesseract_end(tesseract::TessBaseAPI &tess_api)
+  tesseract_pool& get_tesseract_pool()
   {
-    tess_api.End();
+    static tesseract_pool pool;
+    return pool;
   }
+
+
+  // An engine of the pool. Each region is cropped from the page buffer (shared and read-only) so that the engines do
+  // not hold a copy of the whole page.
+  class tesseract_engine
+  {
+  public:
+    explicit tesseract_engine(bool is_line)
+      : m_api(get_tesseract_pool().acquire())
+    {
+      auto seg_mode = tesseract::PSM_SINGLE_BLOCK;
+      if (is_line)
+        seg_mode = tesseract::PSM_SINGLE_LINE;
+
+      m_api->SetPageSegMode(seg_mode);
+    }
+
+    ~tesseract_engine() { get_tesseract_pool().release(std::move(m_api)); }
+
+    tesseract_engine(const tesseract_engine&)            = delete;
+    tesseract_engine& operator=(const tesseract_engine&) = delete;
+
+    std::string recognize(const mln::image2d<uint8_t>& input, const Box& region)
+    {
+      scribo_entering("tesseract::recognize", region.width, region.height);
+      spdlog::debug("Start extraction of rect (x={},y={},w={},h={})", region.x, region.y, region.width, region.height);
+
+      int x0 = std::max(region.x0(), 0);
+      int y0 = std::max(region.y0(), 0);
+      int x1 = std::min(region.x1(), input.width());
+      int y1 = std::min(region.y1(), input.height());
+      if (x1 <= x0 || y1 <= y0)
+        return {};
+
+      const uint8_t* roi = input.buffer() + y0 * input.byte_stride(1) + x0 * input.byte_stride(0);
+      m_api->SetImage(roi, x1 - x0, y1 - y0, input.byte_stride(0), input.byte_stride(1));
+      m_api->SetSourceResolution(150);
+
+      std::unique_ptr<char[]> txt(m_api->GetUTF8Text());
+      return txt ? std::string(txt.get()) : std::string();
+    }
+
+    // Lines and words of the last recognized region (no new recognition)
+    void get_boxes(int region_id, const Box& region, std::vector<scribo::OCRBox>& out)
+    {
+      std::unique_ptr<tesseract::ResultIterator> it(m_api->GetIterator());
+      if (!it || it->Empty(tesseract::RIL_WORD))
+        return;
+
+      int dx = std::max(region.x0(), 0);
+      int dy = std::max(region.y0(), 0);
+      auto add = [&](tesseract::PageIteratorLevel ril, scribo::OCRLevel level) {
+        int l, t, r, b;
+        if (!it->BoundingBox(ril, &l, &t, &r, &b))
+          return;
+        std::unique_ptr<char[]> txt(it->GetUTF8Text(ril));
+        out.push_back({region_id, level, Box{l + dx, t + dy, r - l, b - t}, it->Confidence(ril),
+                       txt ? std::string(txt.get()) : std::string()});
+      };
+
+      do
+      {
+        if (it->IsAtBeginningOf(tesseract::RIL_TEXTLINE))
+          add(tesseract::RIL_TEXTLINE, scribo::OCRLevel::LINE);
+        add(tesseract::RIL_WORD, scribo::OCRLevel::WORD);
+      } while (it->Next(tesseract::RIL_WORD));
+    }
+
+  private:
+    std::unique_ptr<tesseract::TessBaseAPI> m_api;
+  };
 }
 
 auto scribo::TesseractTextExtraction(const mln::image2d<uint8_t>& input, std::span<Box> regions,
-                                     bool is_line) -> std::vector<std::string>
+                                     bool is_line, std::vector<OCRBox>* ocr_boxes) -> std::vector<std::string>
 {
-  tesseract::TessBaseAPI tess_api;
-  tesseract_init(tess_api, input, is_line);
+  scribo_entering("scribo::TesseractTextExtraction", input.width(), input.height());
+  std::vector<Box> boxes;
+  std::vector<int> ids; // Index of the box in the input
+  boxes.reserve(regions.size());
+  ids.reserve(regions.size());
+  for (std::size_t i = 0; i < regions.size(); ++i)
+    if (!regions[i].empty())
+    {
+      boxes.push_back(regions[i]);
+      ids.push_back(i);
+    }
 
-  std::vector<std::string> out;
-  for (const auto& region : regions)
-  {
-    if (region.empty())
-      continue;
+  int n        = (int)boxes.size();
+  int nthreads = std::max(1u, std::thread::hardware_concurrency());
+  int nengines = std::clamp(n / kMinRegionsPerEngine, 1, nthreads);
 
-    spdlog::debug("Start extraction of rect (x={},y={},w={},h={})", region.x, region.y, region.width, region.height);
-    tess_api.SetRectangle(region.x, region.y, region.width, region.height);
+  // The regions are dispatched by decreasing area (the largest ones first for load balancing) to the engines that
+  // pull them as they get idle. The texts are written at the position of their region in the output.
+  std::vector<int> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::ranges::stable_sort(order, std::greater<>(), [&boxes](int i) { return (long)boxes[i].width * boxes[i].height; });
 
-    char* txt = tess_api.GetUTF8Text();
-    out.push_back(txt);
-    delete[] txt;
-  }
+  std::vector<std::string>                out(n);
+  std::vector<std::vector<scribo::OCRBox>> region_boxes(ocr_boxes ? n : 0);
+  std::atomic<int>                        next = 0;
+  auto worker = [&]() {
+    tesseract_engine engine(is_line);
+    for (int k; (k = next++) < n;)
+    {
+      int i  = order[k];
+      out[i] = engine.recognize(input, boxes[i]);
+      if (ocr_boxes)
+        engine.get_boxes(ids[i], boxes[i], region_boxes[i]);
+    }
+  };
+
+  std::vector<std::future<void>> tasks;
+  for (int k = 1; k < nengines; ++k)
+    tasks.push_back(std::async(std::launch::async, worker));
+  worker();
+
+  for (auto& t : tasks)
+    t.get();
 
-  tesseract_end(tess_api);
+  if (ocr_boxes)
+  {
+    ocr_boxes->clear();
+    for (auto& b : region_boxes)
+      std::ranges::move(b, std::back_inserter(*ocr_boxes));
+  }
   return out;
 }
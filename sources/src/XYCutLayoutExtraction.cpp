@@ -1,10 +1,12 @@
 #include "scribo.hpp"
+#include "tracing.hpp"
 #include <mln/core/image/ndimage.hpp>
 
 #include <spdlog/spdlog.h>
 
 #include "signal.hpp"
 #include "Interval.hpp"
+#include "SegmentIndex.hpp"
 #include "config.hpp"
 
 #include <mln/core/se/periodic_line2d.hpp>
@@ -12,8 +14,11 @@
 #include <mln/morpho/opening.hpp>
 //#include <mln/morpho/rank_filter.hpp>
 
+#include <atomic>
 #include <climits>
+#include <future>
 #include <span>
+#include <thread>
 
 namespace
 {
@@ -87,7 +92,7 @@ namespace
         roi.br().y() = b;
       }
 
-      if (kDebugLevel > 1)
+      if (config.kDebugLevel > 1)
       {
         mln::io::imsave(hblock, fmt::format("{}-01-crop-h.tiff", debug_path));
         mln::io::imsave(vblock, fmt::format("{}-02-crop-v.tiff", debug_path));
@@ -98,59 +103,99 @@ namespace
     return roi;
   }
 
-  // Split horizontally (vertical separation)
-  void hsplit(const mln::image2d<uint8_t>& input, std::span<Segment> segments, std::vector<scribo::LayoutRegion>& out, KConfig config,
-              int parent_id, int level = 0);
+  // Data shared by all the splits of a page
+  struct xycut_input
+  {
+    BlackPixelTable layout_black; // Black pixels (< kLayoutWhiteLevel) of the blocks, used for the column profiles
+    BlackPixelTable text_black;   // Black pixels (< kWhiteThreshold) of the blocks, used for the row profiles
+    SegmentIndex    segments;     // Separators of the page
 
+    mutable std::atomic<int> free_threads; // Number of threads that can still be started for the splits
+  };
 
-      // Split vertically - (horizontal separation)
-  void vsplit(const mln::image2d<uint8_t>& input, std::span<Segment> segments, std::vector<scribo::LayoutRegion>& out, KConfig config,
-              int parent_id, int level = 0);
+  // The splits return the regions found in the parent region (and their descendants) as a local list. The parent_id
+  // of a region is an index in this list or kParentRegion for the direct children of the parent region.
+  constexpr int kParentRegion = -2;
 
+  // Sub-splits up to this level run as concurrent tasks (while threads are available), deeper ones run in the calling
+  // thread
+  constexpr int kMaxParallelLevel = 2;
 
-  // Split horizontally (vertical separation)
-  void hsplit(const mln::image2d<uint8_t>& input, std::span<Segment> segments, std::vector<scribo::LayoutRegion>& out, KConfig config,
-              int parent_id, int level)
+  using region_list_t = std::vector<scribo::LayoutRegion>;
+
+  // Append the regions of a sub-split whose parent is out[parent_id]
+  void append_regions(region_list_t& out, const region_list_t& regions, int parent_id)
   {
-    const auto parent = out[parent_id];
-    Box   region = parent.bbox;
+    int offset = static_cast<int>(out.size());
+    for (auto r : regions)
+    {
+      r.parent_id = (r.parent_id == kParentRegion) ? parent_id : r.parent_id + offset;
+      out.push_back(r);
+    }
+  }
 
+  // Run the split in a new thread if one is available, otherwise it is deferred (run by the caller on get()). The
+  // result does not depend on the policy.
+  template <class F>
+  std::future<region_list_t> launch_split(const xycut_input& input, int level, F&& f)
+  {
+    if (level <= kMaxParallelLevel)
+    {
+      int n = input.free_threads.load(std::memory_order_relaxed);
+      while (n > 0 && !input.free_threads.compare_exchange_weak(n, n - 1, std::memory_order_relaxed))
+        ;
+      if (n > 0)
+        return std::async(std::launch::async, [&input, f = std::forward<F>(f)]() mutable {
+          struct release_thread
+          {
+            std::atomic<int>& n;
+            ~release_thread() { n.fetch_add(1, std::memory_order_relaxed); }
+          } guard{input.free_threads};
+          return f();
+        });
+    }
+    return std::async(std::launch::deferred, std::forward<F>(f));
+  }
 
-    // Retrieve segments in the region
-    std::vector<Segment> region_segments;
-    std::vector<Segment> ver_segments;
+  // Split horizontally (vertical separation)
+  region_list_t hsplit(const xycut_input& input, const scribo::LayoutRegion& parent, KConfig config, int level = 0);
 
-    for (const Segment& seg : segments)
-      if (region.has(Point2D{seg.start.x, seg.start.y}) && region.has(Point2D{seg.end.x, seg.end.y}))
-      {
-        region_segments.push_back(seg);
-        if (seg.is_vertical(config.kAngleTolerance))
-          ver_segments.push_back(seg);
-      }
+
+  // Split vertically - (horizontal separation)
+  region_list_t vsplit(const xycut_input& input, const scribo::LayoutRegion& parent, KConfig config, int level = 0);
+
+
+  // Split horizontally (vertical separation)
+  region_list_t hsplit(const xycut_input& input, const scribo::LayoutRegion& parent, KConfig config, int level)
+  {
+    Box region = parent.bbox;
 
 
-    auto rnks = is_number_of_black_pixels_less_than(input.clip(mln::box2d{region.x, region.y, region.width, region.height}), config.kLayoutWhiteLevel, 0.01f, Axis::Y);
+    auto rnks = is_number_of_black_pixels_less_than(input.layout_black, mln::box2d{region.x, region.y, region.width, region.height}, 0.01f, Axis::Y);
     // std::vector<int> rnks    = rank_along_y_axis(blocks2.clip(region), 0.02f);
 
 
-    // For every vertical segment, force the split
-    {
-      for (const auto& s : ver_segments)
-      {
-        spdlog::debug("Vertical split forced by segment (x={}, y1={} y2={} angle={})", s.start.x, s.start.y, s.end.y,
-                      s.angle);
-        float x  = (s.start.x + s.end.x) / 2.f - region.x;
-        int   x0 = std::max(0.f, x - 3 * kExtraMargin);
-        int   x1 = std::min((float)region.width, x + 3 * kExtraMargin);
-        for (int x = x0; x < x1; ++x)
-          rnks[x] = UINT8_MAX; // White out
-      }
-    }
+    // For every vertical segment in the region, force the split
+    input.segments.for_each_in(region, [&](const Segment& s) {
+      if (!s.is_vertical(config.kAngleTolerance))
+        return;
+
+      spdlog::debug("Vertical split forced by segment (x={}, y1={} y2={} angle={})", s.start.x, s.start.y, s.end.y,
+                    s.angle);
+      float x  = (s.start.x + s.end.x) / 2.f - region.x;
+      int   x0 = std::max(0.f, x - 3 * kExtraMargin);
+      int   x1 = std::min((float)region.width, x + 3 * kExtraMargin);
+      for (int x = x0; x < x1; ++x)
+        rnks[x] = UINT8_MAX; // White out
+    });
 
     auto columns = partitions(rnks, config.kColumnMinSpacing);
 
 
     spdlog::debug("{:<{}}** Vertical split - number of regions={}", "", level * 2, columns.size());
+
+    region_list_t                           children;
+    std::vector<std::future<region_list_t>> tasks;
     for (auto [x0, x1] : columns)
     {
       scribo::LayoutRegion sec;
@@ -166,46 +211,35 @@ namespace
         spdlog::error("Invalid parent type {} (Expected: {} or {})", (int)parent.type, (int)DOMCategory::SECTION_LEVEL_1, (int)DOMCategory::SECTION_LEVEL_2);
         throw std::runtime_error("Invalid document layout.");
       }
-      sec.parent_id = parent_id;
+      sec.parent_id = kParentRegion;
 
       spdlog::debug("{:>{}} Detected x-section [{}--{}]", "+", level * 2, x0, x1);
 
-      out.push_back(sec);
+      children.push_back(sec);
       if (sec.type == DOMCategory::COLUMN_LEVEL_1)
-        vsplit(input, std::span{region_segments.begin(), region_segments.end()}, out, config, out.size() - 1, level + 1);
+        tasks.push_back(launch_split(input, level + 1, [&input, sec, config, level] { return vsplit(input, sec, config, level + 1); }));
+      else
+        tasks.emplace_back();
+    }
+
+    // Every column is followed by its descendants
+    region_list_t out;
+    for (std::size_t i = 0; i < children.size(); ++i)
+    {
+      out.push_back(children[i]);
+      if (tasks[i].valid())
+        append_regions(out, tasks[i].get(), static_cast<int>(out.size()) - 1);
     }
+    return out;
   }
 
   // Split vertically - (horizontal separation)
-  void vsplit(const mln::image2d<uint8_t>& input, std::span<Segment> segments, std::vector<scribo::LayoutRegion>& out, KConfig config,
-              int parent_id, int level)
+  region_list_t vsplit(const xycut_input& input, const scribo::LayoutRegion& parent, KConfig config, int level)
   {
     int   kInnerRegion = 10;
-    const auto parent  = out[parent_id];
     Box   region       = parent.bbox;
 
 
-    // Retrieve segments in the region
-    std::vector<Segment> region_segments;
-    std::vector<Segment> hor_segments;
-    IntervalSet          ver_segments;
-
-    {
-      auto outer_region = region;
-      auto inner_region = region;
-      inner_region.inflate(-kInnerRegion);
-
-      for (const Segment& seg : segments)
-      {
-        if (outer_region.has(seg))
-          region_segments.push_back(seg);
-        if (seg.is_horizontal(config.kAngleTolerance) && outer_region.has(seg))
-          hor_segments.push_back(seg);
-        else if (seg.is_vertical(config.kAngleTolerance) && inner_region.has(seg))
-          ver_segments.insert(seg.start.y, seg.end.y);
-      }
-    }
-
     // At level 0, we consider a blank line as 90% of blank pixels (because of separators)
     // At level 1, we consider a blank line if:
     ///   1. There are 95% of blank pixels on the 1st 1/3rd (because a line can be composed of a single word as a large
@@ -226,19 +260,19 @@ namespace
 
       mln::box2d roi = {region.x, region.y, region.width, region.height};
       roi.set_width(w / 4);
-      is_number_of_black_pixels_less_than(input.clip(roi), kWhiteThreshold, config.kCountEmptyLine, Axis::X,
+      is_number_of_black_pixels_less_than(input.text_black, roi, config.kCountEmptyLine, Axis::X,
                                           ysum.data()); // 90% on 1st third
       // rank_along_x_axis(blocks1.clip(roi), 0.05f, ysum.data());
 
       roi.tl().x() = region.x + w / 3;
       roi.br().x() = region.x + 2 * (w / 3);
-      is_number_of_black_pixels_less_than(input.clip(roi), kWhiteThreshold, config.kCountEmptyLine, Axis::X,
+      is_number_of_black_pixels_less_than(input.text_black, roi, config.kCountEmptyLine, Axis::X,
                                           ysum.data() + h); // 90% on the 2nd third
 
 
       roi.tl().x() = region.x + 2 * (w / 3);
       roi.br().x() = region.x + w;
-      is_number_of_black_pixels_less_than(input.clip(roi), kWhiteThreshold, config.kCountEmptyLine, Axis::X,
+      is_number_of_black_pixels_less_than(input.text_black, roi, config.kCountEmptyLine, Axis::X,
                                           ysum.data() + 2 * h); // 90% on the 3rd third
       // rank_along_x_axis(blocks1.clip(roi), 0.3f, ysum.data() + h); // 50% on 2nd third
 
@@ -252,11 +286,21 @@ namespace
     }
 
     // For every horizontal segment > 25% of the block width, force the split
+    // (vertical segments in the inner region are collected to prevent the split)
+    IntervalSet ver_segments;
     {
-      for (const auto& s : hor_segments)
-      {
+      auto inner_region = region;
+      inner_region.inflate(-kInnerRegion);
+
+      input.segments.for_each_in(region, [&](const Segment& s) {
+        if (!s.is_horizontal(config.kAngleTolerance))
+        {
+          if (s.is_vertical(config.kAngleTolerance) && inner_region.has(s))
+            ver_segments.insert(s.start.y, s.end.y);
+          return;
+        }
         if (s.length < 0.25f * region.width)
-          continue;
+          return;
 
         spdlog::debug("Horizontal split forced by segment (y={}, x1={} x2={} angle={})", s.start.y, s.start.x, s.end.x,
                       s.angle);
@@ -264,7 +308,7 @@ namespace
         int y1 = std::min(s.end.y + 3, region.y1()) - region.y;
         for (int y = y0; y < y1; ++y)
           ysum[y] = 255; // White out
-      }
+      });
     }
     // For every vertical segment in the region => no split
     {
@@ -284,12 +328,12 @@ namespace
     
     spdlog::debug("{:<{}}** Horizontal split - number of regions={}", "", level * 2, DOM.size());
 
+    region_list_t         out;
     scribo::LayoutRegion* last = nullptr;
-    int           children_start = out.size();
     for (auto [y0, y1] : DOM)
     {
       last            = &out.emplace_back();
-      last->parent_id = parent_id;
+      last->parent_id = kParentRegion;
       y0              = y0 + region.y - kExtraMargin;
       y1              = y1 + region.y + kExtraMargin;
 
@@ -325,13 +369,19 @@ namespace
     }
 
 
-    int children_end = out.size();
-    for (int i = children_start; i < children_end; i++)
+    // The sections are followed by the descendants of each section
+    int                                     n_children = static_cast<int>(out.size());
+    std::vector<std::future<region_list_t>> tasks(n_children);
+    for (int i = 0; i < n_children; i++)
     {
       auto sec = out[i];
       if (sec.type == DOMCategory::SECTION_LEVEL_1 || sec.type == DOMCategory::SECTION_LEVEL_2)
-        hsplit(input, std::span{region_segments.begin(), region_segments.end()}, out, config, i, level + 1);
+        tasks[i] = launch_split(input, level + 1, [&input, sec, config, level] { return hsplit(input, sec, config, level + 1); });
     }
+    for (int i = 0; i < n_children; i++)
+      if (tasks[i].valid())
+        append_regions(out, tasks[i].get(), i);
+    return out;
   }
 } // namespace
 
@@ -340,14 +390,15 @@ namespace scribo
 {
 
   // Extract the top-level blocks (Sections + Columns + Sub-section + Sub-column)
-  auto XYCutLayoutExtraction(const mln::image2d<uint8_t>& input, std::span<Segment> segments, KConfig config)
-      -> std::vector<scribo::LayoutRegion>
+  auto XYCutLayoutExtraction(const mln::image2d<uint8_t>& input, std::span<Segment> segments, KConfig config,
+                             int n_threads) -> std::vector<scribo::LayoutRegion>
   {
+    scribo_entering("scribo::XYCutLayoutExtraction", input.width(), input.height());
     const char* debug_path = "debug";
 
     using mln::point2d;
 
-    if (kDebugLevel > 1)
+    if (config.kDebugLevel > 1)
       mln::io::imsave(input, fmt::format("{}-00-input.tiff", debug_path));
 
     // 1. Page region detection
@@ -369,7 +420,7 @@ namespace scribo
         mln::se::periodic_line2d l(point2d{1, 0}, config.kLayoutBlockOpeningWidth / 2);
         blocks = mln::morpho::opening(blocks, l);
       }
-      if (kDebugLevel > 1)
+      if (config.kDebugLevel > 1)
         mln::io::imsave(blocks, fmt::format("{}-03-blocks.tiff", debug_path));
     }
 
@@ -380,7 +431,7 @@ namespace scribo
     //   mln::se::periodic_line2d l(point2d{1, 0}, 3); // was 3
     //   using R = std::ratio<5, 7>;
     //   blocks2 = mln::morpho::rank_filter<R>(blocks, l, mln::extension::bm::fill(uint8_t(255)));
-    //   if (kDebugLevel > 1)
+    //   if (config.kDebugLevel > 1)
     //     mln::io::imsave(blocks2, fmt::format("{}-04-blocks.tiff", debug_path));
     // }
 
@@ -392,7 +443,14 @@ namespace scribo
     page.bbox = {roi.x(), roi.y(), roi.width(), roi.height()};
     page.type = DOMCategory::PAGE;
     out.push_back(page);
-    vsplit(blocks, segments, out, config, 0);
+    // 4. Build the black pixel counts and the separator index once, all the splits read them
+    xycut_input data = {
+        .layout_black = BlackPixelTable(blocks, config.kLayoutWhiteLevel),
+        .text_black   = BlackPixelTable(blocks, kWhiteThreshold),
+        .segments     = SegmentIndex(segments),
+        .free_threads = (n_threads > 0 ? n_threads : static_cast<int>(std::thread::hardware_concurrency())) - 1,
+    };
+    append_regions(out, vsplit(data, page, config, 0), 0);
     return out;
   }
 }
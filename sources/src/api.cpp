@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cctype>
 #include <iostream>
 #include <string>
 #include <string_view>
@@ -19,6 +21,7 @@
 
 #include "scribo.hpp"
 #include "process.hpp"
+#include <tracing.hpp>
 #include <sstream>
 
 
@@ -111,15 +114,31 @@ void process(std::string_view directory, std::variant<std::string_view, int> vie
 
 
 
+/// True if the value of a boolean header is 1, true, yes or on (case-insensitive)
+static bool header_flag(std::string_view value)
+{
+    while (!value.empty() && value.front() == ' ')
+        value.remove_prefix(1);
+    while (!value.empty() && value.back() == ' ')
+        value.remove_suffix(1);
+
+    for (std::string_view v : {"1", "true", "yes", "on"})
+        if (std::ranges::equal(value, v, [](char a, char b) { return std::tolower(static_cast<unsigned char>(a)) == b; }))
+            return true;
+    return false;
+}
+
 /// @brief  Get the layout of the document
 /// The payload of the request should be an image (webp or jpeg) in the body of the request
+/// If the header "X-Scribo-Trace" is true (1, true, yes or on), the response is {"layout": <layout>, "trace": <Chrome trace>}
 /// @param res 
 /// @param req 
 void get_layout(uWS::HttpResponse<false> *res, uWS::HttpRequest *req) {
     std::vector<std::byte> _buffer;
+    bool trace = header_flag(req->getHeader("x-scribo-trace"));
 
     // Get the json payload from the request and parse it
-    res->onData([buffer = &_buffer, res](std::string_view data, bool last) {
+    res->onData([buffer = &_buffer, res, trace](std::string_view data, bool last) {
         auto tmp = (const std::byte*) data.data();
         buffer->insert(buffer->end(), tmp, tmp + data.size());
         if (last) {
@@ -142,17 +161,36 @@ void get_layout(uWS::HttpResponse<false> *res, uWS::HttpRequest *req) {
                 spdlog::info("Extracting layout from image.");
                 auto start = std::chrono::high_resolution_clock::now();
                 auto image = mln::io::imread_from_bytes(*buffer);
+
+                // The requests are processed one at a time by the event loop, so the trace holds this request only
+                if (trace)
+                    scribo::trace::enable();
         
                 process(image, p);
 
                 auto end = std::chrono::high_resolution_clock::now();
                 auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
                 spdlog::info("Layout extraction took {}ms", duration.count());
+
+                if (trace) {
+                    scribo::trace::enable(false);
+                    std::ostringstream body;
+                    body << "{\"layout\": " << ss.view() << ", \"trace\": ";
+                    scribo::trace::write_chrome_trace(body);
+                    body << "}";
+                    scribo::trace::clear();
+                    ss = std::move(body);
+                }
+
                 res->writeStatus("200 OK")
                    ->writeHeader("Content-Type", "text/json")
                    ->end(ss.view());
             }
             catch (const std::exception& e) {
+                if (trace) {
+                    scribo::trace::enable(false);
+                    scribo::trace::clear();
+                }
                 spdlog::error("Error: {}", e.what());
                 res->writeStatus("400 Bad Request")
                    ->writeHeader("Content-Type", "text/plain")
@@ -171,6 +209,7 @@ void get_layout(uWS::HttpResponse<false> *res, uWS::HttpRequest *req) {
 
 static const char* usage = R"(Document processing API
     POST /imgproc/layout : Get the layout of the document (Pass the image in the body of the request, returns a json with the layout)
+                           With the header "X-Scribo-Trace: 1", returns {"layout": <layout>, "trace": <Chrome trace>}
     GET  /imgproc/deskew?directory=<directory>&view=<view> : Process the image from the given directory and view
     POST /imgproc/deskew : Process the image from the given directory and view
     {
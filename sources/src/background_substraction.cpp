@@ -17,7 +17,7 @@
 #include <mln/data/stretch.hpp>
 
 #include <fmt/core.h>
-#include <mln/core/trace.hpp>
+#include <tracing.hpp>
 #include "signal.hpp"
 #include <mln/io/imsave.hpp>
 #include <spdlog/spdlog.h>
@@ -73,7 +73,7 @@ namespace scribo
 
     mln::image2d<uint8_t> background_substraction(const mln::image2d<uint8_t>& input, int& xw, int& xh, bool denoise)
     {
-        mln_entering("background-substraction");
+        scribo_entering("background-substraction", input.width(), input.height());
         constexpr int border = 10;
 
         if (input.width() != 2048 && input.width() != 2047)
@@ -4,6 +4,7 @@
 #include <mln/core/algorithm/for_each.hpp>
 #include <mln/data/stretch.hpp>
 #include "subsample.hpp"
+#include <tracing.hpp>
 
 namespace
 {
@@ -29,6 +30,7 @@ namespace scribo
      mln::image2d<uint8_t> clean_document(const mln::image2d<uint8_t>& input_, cleaning_parameters& params,
                                         mln::image2d<uint8_t>* deskewed)
     {
+        scribo_entering("scribo::clean_document", input_.width(), input_.height());
         auto input = input_;
         auto inverse = [](uint8_t& x) { x = 255 - x;};
         mln::for_each(input, inverse);
@@ -1,22 +1,43 @@
 #include "config.hpp"
+#include <scribo.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include <atomic>
 #include <cmath>
 
-int kDebugLevel = 0;
+namespace
+{
+  std::atomic<int> g_debug_level = 0;
+}
+
+namespace scribo
+{
+  void set_debug_level(int debug_level) noexcept
+  {
+    g_debug_level = debug_level;
+    if (debug_level == 0)
+      spdlog::set_level(spdlog::level::level_enum::info);
+    else
+      spdlog::set_level(spdlog::level::level_enum::debug);
+  }
+
+  int get_debug_level() noexcept { return g_debug_level; }
+} // namespace scribo
 
 
-float KConfig::kLineHorizontalSigma = 10;
-float KConfig::kLineVerticalSigma   = 3;
-float KConfig::kAngleTolerance      = 5.f;
-int   KConfig::kLayoutPageOpeningWidth  = 200 * 2;
-int   KConfig::kLayoutPageOpeningHeight = 200 * 2;
-float KConfig::kLayoutPageFullLineWhite = 0.95f;
-float KConfig::kLayoutPageMargin = 0.1f;
-int   KConfig::kLayoutWhiteLevel = 150;
-float KConfig::kLayoutBlockFillingRatio = 0.5f;
-float KConfig::kPourcentEmptyColumn = 0.1f;
-float KConfig::kPourcentEmptyLine = 0.1f;
+KConfig::KConfig()
+  : kDebugLevel{scribo::get_debug_level()}
+{
+}
 
 KConfig::KConfig(int xheight, int scale)
+  : KConfig()
+{
+  set_xheight(xheight, scale);
+}
+
+void KConfig::set_xheight(int xheight, int scale)
 {
   if (scale == 0)
     xheight /= 2;
@@ -43,5 +64,3 @@ KConfig::KConfig(int xheight, int scale)
   kSectionMinSpacing = int(std::round(0.5f * xheight));
   kSectionMinSize = int(std::round(xheight));
 }
-
-
@@ -1,53 +1,62 @@
 #pragma once
 
-extern int kDebugLevel;
-
 
+/// \brief Parameters of the layout extraction
+///
+/// A configuration is passed by value through the pipeline, so that pages with different settings can be processed
+/// concurrently. The first parameters depend on the x-height (see set_xheight()), the others are tunables with
+/// default values.
 struct KConfig
 {
   /// Constants for text blocks in mm
   /// \{
   // Number of pixels between two consecutive baselines
-  float kLineHeight;
+  float kLineHeight = 0;
 
   // Number of blank pixels (spacing) between two words
-  float kWordSpacing;
+  float kWordSpacing = 0;
 
   // Number of approximative pixels for the word "Word"
-  float kWordWidth;
-  float kxheight;
-  float kOneEm;
+  float kWordWidth = 0;
+  float kxheight   = 0;
+  float kOneEm     = 0;
 
   // Column-split related parameters
-  int kColumnMinSpacing;
-  int kColumnMinSize;
-  static float kPourcentEmptyColumn; /// Pourcent of black so that the column is considered empty 
+  int   kColumnMinSpacing    = 0;
+  int   kColumnMinSize       = 0;
+  float kPourcentEmptyColumn = 0.1f; /// Pourcent of black so that the column is considered empty
 
   // Section-split related parameters
-  int kSectionMinSpacing;
-  int kSectionMinSize;
-  int kCountEmptyLine;
-  static float kPourcentEmptyLine; /// Pourcent of black so that the line is considered empty
+  int   kSectionMinSpacing = 0;
+  int   kSectionMinSize    = 0;
+  int   kCountEmptyLine    = 0;
+  float kPourcentEmptyLine = 0.1f; /// Pourcent of black so that the line is considered empty
   // \}
 
-  static float kLineHorizontalSigma;
-  static float kLineVerticalSigma;
-  static float kAngleTolerance;    // Maximal deviation in degree that makes consider a line as a vertical line
+  float kLineHorizontalSigma = 10;
+  float kLineVerticalSigma   = 3;
+  float kAngleTolerance      = 5.f; // Maximal deviation in degree that makes consider a line as a vertical line
+
+  int   kLayoutPageOpeningWidth  = 200 * 2;
+  int   kLayoutPageOpeningHeight = 200 * 2;
+  float kLayoutPageFullLineWhite = 0.95f; // Number of white pixels for which we consider a line/column to be white
+  float kLayoutPageMargin        = 0.1f;  // 1/kBorderPageRatio Maximal crop size
 
-  static int   kLayoutPageOpeningWidth;
-  static int   kLayoutPageOpeningHeight;
-  static float kLayoutPageFullLineWhite; // Number of white pixels for which we consider a line/column to be white
-  static float kLayoutPageMargin;        // 1/kBorderPageRatio Maximal crop size
 
+  int kLayoutWhiteLevel = 150;
 
-  static int kLayoutWhiteLevel;
+  float kLayoutBlockFillingRatio  = 0.5f;
+  int   kLayoutBlockOpeningWidth  = 0;
+  int   kLayoutBlockOpeningHeight = 0;
+  int   kLayoutBlockMinHeight     = 0;
+  int   kLayoutBlockMinWidth      = 0;
 
-  static float kLayoutBlockFillingRatio;
-  int   kLayoutBlockOpeningWidth;
-  int   kLayoutBlockOpeningHeight;
-  int   kLayoutBlockMinHeight;
-  int   kLayoutBlockMinWidth;
+  int kDebugLevel; // Save the intermediate images if > 1 (defaults to scribo::get_debug_level())
 
-  KConfig() = delete;
+  /// Default tunables, the x-height dependent parameters are not set
+  KConfig();
   KConfig(int xheight, int scale);
+
+  /// Compute the x-height dependent parameters (the tunables are kept)
+  void set_xheight(int xheight, int scale);
 };
@@ -2,6 +2,7 @@
 
 #include <mln/core/image/ndimage.hpp>
 #include <spdlog/spdlog.h>
+#include <tracing.hpp>
 #include <cmath>
 
 #include "config.hpp"
@@ -68,6 +69,7 @@ namespace scribo
 
   mln::image2d<uint8_t> deskew_image(const mln::image2d<uint8_t> &input, float angle, uint8_t fill_value)
   {
+    scribo_entering("scribo::deskew_image", input.width(), input.height());
     mln::image2d<uint8_t> out = mln::imconcretize(input).set_init_value(0);
 
     float c      = std::cos(angle * M_PI / 180);
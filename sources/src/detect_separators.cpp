@@ -1,6 +1,7 @@
 #include "detect_separators.hpp"
+#include <scribo.hpp>
+#include <tracing.hpp>
 
-#include <mln/core/algorithm/transform.hpp>
 #include <mln/core/image/ndimage.hpp>
 #include <scribo/segdet.hpp>
 
@@ -11,88 +12,212 @@ extern "C"
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
 #include <cmath>
+#include <future>
+#include <thread>
 
 namespace
 {
   // Configuration
   constexpr int kValidRegionBorder = 100;
   constexpr int kMinLength = 100;
-}
 
+  // Merge of the segments cut by the band boundaries (tiled detection)
+  constexpr float kMergeAngleTolerance = 2.f; // Maximal angle difference (in degree)
+  constexpr float kMergeMaxOffset      = 2.f; // Maximal distance of the end-points to the other segment line
+  constexpr float kMergeMaxGap         = 2.f; // Maximal gap between the two segments along their direction (they should overlap)
 
-std::vector<Segment> detect_separators_LSD(const mln::image2d<uint8_t>& input)
-{
-  // Convert to double for LSD with no-border
-  mln::image_build_params params;
-  params.border = 0;
 
-  mln::image2d<double> f(input.domain(), params);
-  mln::transform(input, f, [](uint8_t x) { return static_cast<double>(x); });
+  // Run LSD on the whole image (no filtering). The coordinates are relative to the top-left corner of the image.
+  std::vector<Segment> run_LSD(const mln::image2d<uint8_t>& input)
+  {
+    // Run LSD (directly on the 8-bit buffer, the 0.5 subsampling is done by a box filter inside LSD)
+    int n_segment = 0;
+    double* results;
+    {
+      const uint8_t* buf  = input.buffer();
+      double  scale       = 0.5;
+      double  sigma_scale = 0.6; /* Sigma for Gaussian filter is computed as
+                                 sigma = sigma_scale/scale.                    */
+      double quant = 2.0;        /* Bound to the quantization error on the
+                                     gradient norm.                                */
+      double ang_th     = 22.5;  /* Gradient angle tolerance in degrees.           */
+      double log_eps    = 2.0;   /* Detection threshold: -log10(NFA) > log_eps     */
+      double density_th = 0.7;   /* Minimal density of region points in rectangle. */
+      int    n_bins     = 1024;  /* Number of bins in pseudo-ordering of gradient
+                                    modulus.                                       */
+
+      results = LineSegmentDetection_u8(&n_segment, buf, input.width(), input.height(), static_cast<int>(input.stride()),
+                                        scale, sigma_scale, quant, ang_th, log_eps, density_th, n_bins);
+    }
+
+    // Convert back the segments
+    std::vector<Segment> segments;
+    segments.reserve(n_segment);
+    double* res = results;
+    for (int i = 0; i < n_segment; ++i)
+    {
+      Segment s;
+      s.start = {(int)res[0], (int)res[1]};
+      s.end   = {(int)res[2], (short)res[3]};
+      if (s.end.y < s.start.y)
+        std::swap(s.start, s.end);
 
+      s.length = std::hypot(res[2] - res[0], res[3] - res[1]);
+      s.angle  = std::atan2(res[3] - res[1], res[2] - res[0]) * 180 / M_PI;
+      if (s.angle < 0)
+        s.angle += 180.;
+      s.width = res[4];
+      s.nfa   = res[6];
 
-  // Run LSD
-  int n_segment = 0;
-  double* results;
+
+      segments.push_back(s);
+      res += 7;
+    }
+    free(results);
+    return segments;
+  }
+
+  // Remove the segments close to the page border and the small ones
+  void filter_segments(std::vector<Segment>& segments, mln::box2d domain)
   {
-    int*    tmp = nullptr;
-    int     x, y;
-    double* buf         = f.buffer();
-    double  scale       = 0.5;
-    double  sigma_scale = 0.6; /* Sigma for Gaussian filter is computed as
-                               sigma = sigma_scale/scale.                    */
-    double quant = 2.0;        /* Bound to the quantization error on the
-                                   gradient norm.                                */
-    double ang_th     = 22.5;  /* Gradient angle tolerance in degrees.           */
-    double log_eps    = 2.0;   /* Detection threshold: -log10(NFA) > log_eps     */
-    double density_th = 0.7;   /* Minimal density of region points in rectangle. */
-    int    n_bins     = 1024;  /* Number of bins in pseudo-ordering of gradient
-                                  modulus.                                       */
-
-    results = LineSegmentDetection(&n_segment, buf, f.width(), f.height(), scale, sigma_scale, quant, ang_th, log_eps, density_th,
-                                   n_bins, nullptr, nullptr, nullptr);
-    //auto tmpi = mln::image2d<int>::from_buffer((void*)tmp, mln::box2d{{0, 0}, {y, x}});
-    //mln::io::imsave(tmpi, "tmp.tiff");
+    auto end          = segments.end();
+    auto valid_region = domain;
+    valid_region.inflate(-kValidRegionBorder);
+    end = std::remove_if(segments.begin(), end, [valid_region](const auto& s) {
+      bool valid = true;
+      valid &= valid_region.has(mln::point2d{s.start.x, s.start.y});
+      valid &= valid_region.has(mln::point2d{s.end.x, s.end.y});
+      valid &= s.length >= kMinLength;
+      return !valid;
+    });
+
+    segments.resize(end - segments.begin());
   }
 
-  // Convert back the segments
-  std::vector<Segment> segments;
-  double* res = results;
-  for (int i = 0; i < n_segment; ++i)
+
+  // True if the segments have the same direction, are on the same line and overlap (or almost touch)
+  bool are_collinear(const Segment& a, const Segment& b)
   {
-    Segment s;
-    s.start = {(int)res[0], (int)res[1]};
-    s.end   = {(int)res[2], (short)res[3]};
-    if (s.end.y < s.start.y)
-      std::swap(s.start, s.end);
+    float da = std::abs(a.angle - b.angle);
+    if (std::min(da, 180.f - da) > kMergeAngleTolerance)
+      return false;
 
-    s.length = std::hypot(res[2] - res[0], res[3] - res[1]);
-    s.angle  = std::atan2(res[3] - res[1], res[2] - res[0]) * 180 / M_PI;
-    if (s.angle < 0)
-      s.angle += 180.;
-    s.width = res[4];
-    s.nfa   = res[6];
+    // Work in the frame of the longest segment
+    const Segment& r = (a.length >= b.length) ? a : b;
+    const Segment& o = (a.length >= b.length) ? b : a;
+    if (r.length <= 0)
+      return false;
 
+    float ux = (r.end.x - r.start.x) / float(r.length);
+    float uy = (r.end.y - r.start.y) / float(r.length);
 
-    segments.push_back(s);
-    res += 7;
+    auto project = [&](Point2D p) {
+      float dx = p.x - r.start.x;
+      float dy = p.y - r.start.y;
+      return std::make_pair(dx * ux + dy * uy, std::abs(dx * uy - dy * ux)); // (abscissa, offset)
+    };
+
+    auto [t0, d0] = project(o.start);
+    auto [t1, d1] = project(o.end);
+    if (std::max(d0, d1) > kMergeMaxOffset)
+      return false;
+
+    float gap = std::max(std::min(t0, t1) - float(r.length), -std::max(t0, t1));
+    return gap <= kMergeMaxGap;
   }
-  free(results);
 
+  // Merge the segment b into a (the extremal end-points are kept)
+  void merge_into(Segment& a, const Segment& b)
+  {
+    Point2D pts[4] = {a.start, a.end, b.start, b.end};
 
-  // Filter segments
-  auto end          = segments.end();
-  auto valid_region = f.domain();
-  valid_region.inflate(-kValidRegionBorder);
-  end = std::remove_if(segments.begin(), end, [valid_region](const auto& s) {
-    bool valid = true;
-    valid &= valid_region.has(mln::point2d{s.start.x, s.start.y});
-    valid &= valid_region.has(mln::point2d{s.end.x, s.end.y});
-    valid &= s.length >= kMinLength;
-    return !valid;
-  });
+    // Find the two most distant points
+    int    i0 = 0, i1 = 1;
+    double dmax = -1;
+    for (int i = 0; i < 4; ++i)
+      for (int j = i + 1; j < 4; ++j)
+        if (double d = std::hypot(pts[i].x - pts[j].x, pts[i].y - pts[j].y); d > dmax)
+        {
+          dmax = d;
+          i0   = i;
+          i1   = j;
+        }
 
-  segments.resize(end - segments.begin());
+    a.start = pts[i0];
+    a.end   = pts[i1];
+    if (a.end.y < a.start.y)
+      std::swap(a.start, a.end);
+
+    a.length = dmax;
+    a.angle  = std::atan2(a.end.y - a.start.y, a.end.x - a.start.x) * 180 / M_PI;
+    if (a.angle < 0)
+      a.angle += 180.;
+    a.width = std::max(a.width, b.width);
+    a.nfa   = std::max(a.nfa, b.nfa);
+  }
+
+
+  // A segment detected in the bands [kmin, kmax]
+  struct band_segment
+  {
+    Segment s;
+    int     kmin;
+    int     kmax;
+  };
+
+  // Merge the collinear segments detected in adjacent bands. The segments must be sorted by band. The bands are swept
+  // in order: a segment of the band k is merged into a collinear segment that reaches the band k-1 (itself possibly
+  // already merged), so a rule crossing several bands is chained into a single segment. Two segments from the same
+  // band are never merged (e.g. the two edges of a thick rule).
+  void merge_collinear_segments(std::vector<band_segment>& segments)
+  {
+    std::vector<band_segment> merged;
+    merged.reserve(segments.size());
+
+    std::vector<int> open;      // Segments (in merged) that reach the previous band
+    std::vector<int> next_open; // Segments (in merged) that reach the current band
+
+    std::size_t i = 0;
+    while (i < segments.size())
+    {
+      const int k = segments[i].kmin;
+      next_open.clear();
+      for (; i < segments.size() && segments[i].kmin == k; ++i)
+      {
+        const auto& seg = segments[i];
+        auto it = std::find_if(open.begin(), open.end(), [&](int m) {
+          return merged[m].kmax + 1 == k && are_collinear(merged[m].s, seg.s);
+        });
+        if (it != open.end())
+        {
+          int m = *it;
+          merge_into(merged[m].s, seg.s);
+          merged[m].kmax = k;
+          next_open.push_back(m);
+          // A segment is chained with at most one segment of the band
+          *it = open.back();
+          open.pop_back();
+        }
+        else
+        {
+          next_open.push_back(static_cast<int>(merged.size()));
+          merged.push_back(seg);
+        }
+      }
+      std::swap(open, next_open);
+    }
+
+    segments = std::move(merged);
+  }
+}
+
+
+std::vector<Segment> detect_separators_LSD(const mln::image2d<uint8_t>& input)
+{
+  auto segments = run_LSD(input);
+  filter_segments(segments, input.domain());
 
   // Debug
   spdlog::debug("LSD - Detected segments");
@@ -106,11 +231,113 @@ std::vector<Segment> detect_separators_LSD(const mln::image2d<uint8_t>& input)
 }
 
 
-std::vector<Segment> detect_separators_Kalman(const mln::image2d<uint8_t>& input, mln::image2d<uint8_t>* binseg)
+std::vector<Segment> detect_separators_LSD_tiled(const mln::image2d<uint8_t>& input, int n_bands, int overlap)
 {
+  int height = input.height();
+  n_bands    = std::clamp(n_bands, 1, std::max(1, height / (4 * overlap + 1)));
+  if (n_bands == 1)
+    return detect_separators_LSD(input);
 
-  auto segs = scribo::detect_line_vector(input, kMinLength);
+  auto domain = input.domain();
+  int  x0     = domain.x();
+  int  y0     = domain.y();
 
+  // Band k covers the rows [bounds[k], bounds[k+1]) extended by the overlap
+  std::vector<int> bounds(n_bands + 1);
+  for (int k = 0; k <= n_bands; ++k)
+    bounds[k] = (k * height) / n_bands;
+
+  std::vector<std::future<std::vector<Segment>>> tasks;
+  tasks.reserve(n_bands);
+  for (int k = 0; k < n_bands; ++k)
+  {
+    int a = std::max(0, bounds[k] - overlap);
+    int b = std::min(height, bounds[k + 1] + overlap);
+    tasks.push_back(std::async(std::launch::async, [&input, x0, y0, a, b]() {
+      auto band     = input.clip(mln::box2d{x0, y0 + a, input.width(), b - a});
+      auto segments = run_LSD(band);
+      for (auto& s : segments)
+      {
+        s.start.y += a;
+        s.end.y += a;
+      }
+      return segments;
+    }));
+  }
+
+  // Segments that reach a band boundary (+/- overlap) may be cut or duplicated and must be merged with the others
+  auto near_boundary = [&](const Segment& s) {
+    for (int k = 1; k < n_bands; ++k)
+      if (s.start.y <= bounds[k] + overlap && s.end.y >= bounds[k] - overlap)
+        return true;
+    return false;
+  };
+
+  std::vector<Segment>      segments;
+  std::vector<band_segment> to_merge;
+  for (int k = 0; k < n_bands; ++k)
+    for (const auto& s : tasks[k].get())
+    {
+      if (near_boundary(s))
+        to_merge.push_back({s, k, k});
+      else
+        segments.push_back(s);
+    }
+
+  spdlog::debug("LSD - {} bands, {} segments at band boundaries", n_bands, to_merge.size());
+  merge_collinear_segments(to_merge);
+  for (const auto& m : to_merge)
+    segments.push_back(m.s);
+
+  filter_segments(segments, domain);
+
+  // Debug
+  spdlog::debug("LSD (tiled) - Detected segments");
+  for (const auto& s : segments)
+  {
+    spdlog::debug("x1={} y1={} x2={} y2={} width={} nfa={} length={} angle={}", s.start.x, s.start.y, s.end.x,
+                  s.end.y, s.width, s.nfa, s.length, s.angle);
+  }
+
+  return segments;
+}
+
+
+std::vector<Segment> detect_separators_Kalman(const mln::image2d<uint8_t>& input)
+{
+  auto vsegs = scribo::detect_line_vector(input, kMinLength);
+
+  // Convert the pylene segments
+  std::vector<Segment> segments;
+  segments.reserve(vsegs.size());
+  for (const auto& v : vsegs)
+  {
+    Segment s;
+    s.start = {v.x0, v.y0};
+    s.end   = {v.x1, v.y1};
+    if (s.end.y < s.start.y)
+      std::swap(s.start, s.end);
+
+    s.length = std::hypot(v.x1 - v.x0, v.y1 - v.y0);
+    s.angle  = std::atan2(s.end.y - s.start.y, s.end.x - s.start.x) * 180 / M_PI;
+    if (s.angle < 0)
+      s.angle += 180.;
+    s.width = 0; // Not provided by the tracker
+    s.nfa   = 0; // Not provided by the tracker
+    segments.push_back(s);
+  }
+
+  filter_segments(segments, input.domain());
+
+  // Debug
+  spdlog::debug("Kalman - Detected segments");
+  for (const auto& s : segments)
+  {
+    spdlog::debug("x1={} y1={} x2={} y2={} length={} angle={}", s.start.x, s.start.y, s.end.x, s.end.y, s.length,
+                  s.angle);
+  }
+
+  return segments;
 }
 
 
@@ -119,9 +346,20 @@ std::vector<Segment> detect_separators_Kalman(const mln::image2d<uint8_t>& input
 namespace scribo
 {
 
-  auto extract_segments(const mln::image2d<uint8_t>& input) -> std::vector<Segment>
+  auto extract_segments(const mln::image2d<uint8_t>& input, const segment_detection_parameters& params)
+      -> std::vector<Segment>
   {
-    return detect_separators_LSD(input);
+    scribo_entering("scribo::extract_segments", input.width(), input.height());
+    if (params.method == segment_detection_parameters::KALMAN)
+      return detect_separators_Kalman(input);
+
+    int n_bands = params.n_bands;
+    if (n_bands <= 0)
+      n_bands = std::max(1u, std::thread::hardware_concurrency());
+
+    if (n_bands == 1)
+      return detect_separators_LSD(input);
+    return detect_separators_LSD_tiled(input, n_bands, params.band_overlap);
   }
 
 }
@@ -8,4 +8,12 @@
 
 
 std::vector<Segment> detect_separators_LSD(const mln::image2d<uint8_t>& input);
-std::vector<Segment> detect_seperators_Kalman(const mln::image2d<uint8_t>& input, mln::image2d<bool>* binseg);
+
+/// Same as detect_separators_LSD but the page is split in \p n_bands horizontal bands (overlapping of \p overlap pixels)
+/// processed in parallel. The collinear segments crossing the band boundaries are merged.
+std::vector<Segment> detect_separators_LSD_tiled(const mln::image2d<uint8_t>& input, int n_bands, int overlap);
+
+/// Detect the separators with the Kalman-based line tracker of pylene (scribo::detect_line_vector). It only tracks long
+/// lines. The segments are filtered as in detect_separators_LSD. Its speed and recall are compared with LSD's in
+/// bench/BMSegments.cpp.
+std::vector<Segment> detect_separators_Kalman(const mln::image2d<uint8_t>& input);
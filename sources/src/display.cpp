@@ -71,7 +71,8 @@ namespace
   }
 
   
-  void draw_ws_lines(const mln::image2d<int16_t>& lbls, mln::image2d<mln::rgb8>& out)
+  template <class Label>
+  void draw_ws_lines(const mln::image2d<Label>& lbls, mln::image2d<mln::rgb8>& out)
   {
     auto z = mln::view::zip(lbls, out);
     mln::for_each(z, [](const auto& v) {
@@ -82,8 +83,9 @@ namespace
   }
 
     
+  template <class Label>
   void labelize_line(const mln::image2d<uint8_t>& input_,  //
-                     const mln::image2d<int16_t>& ws_,     //
+                     const mln::image2d<Label>&   ws_,     //
                      mln::image2d<bgra_t>&        output_,
                      std::span<scribo::LayoutRegion> regions,
                      int label)
@@ -118,6 +120,18 @@ namespace
       }
   }
 
+  // Call f with the line labels (16-bit or 32-bit, see WSLineExtractionAnyLabel())
+  template <class F>
+  void visit_labels(const mln::ndbuffer_image& ws, F f)
+  {
+    if (const auto* lbls = ws.cast_to<int16_t, 2>())
+      f(*lbls);
+    else if (const auto* lbls = ws.cast_to<int32_t, 2>())
+      f(*lbls);
+    else
+      spdlog::error("Unsupported type for the line labels.");
+  }
+
 } // namespace
 
 
@@ -125,7 +139,7 @@ mln::image2d<mln::rgb8> //
 display(const mln::image2d<uint8_t>& input,
         std::span<scribo::LayoutRegion> regions,
         std::span<Segment> segments,
-        mln::image2d<int16_t>* ws,
+        const mln::ndbuffer_image* ws,
         int display_options)
 {
   //auto lbls = data->ws;
@@ -175,15 +189,18 @@ display(const mln::image2d<uint8_t>& input,
   }
   ctx.end();
 
-  for (std::size_t i = 0; i < regions.size(); ++i)
-    if (regions[i].type == DOMCategory::LINE)
-      labelize_line(input, *ws, out, regions, i);
+  if (ws != nullptr)
+    visit_labels(*ws, [&](const auto& lbls) {
+      for (std::size_t i = 0; i < regions.size(); ++i)
+        if (regions[i].type == DOMCategory::LINE)
+          labelize_line(input, lbls, out, regions, i);
+    });
 
   auto res = mln::transform(out, [](const bgra_t& x) -> mln::rgb8 { return {x.r, x.g, x.b}; });
 
   // Draw watershed lines
   if ((display_options & DISPLAY_WS) && ws != nullptr)
-    draw_ws_lines(*ws, res);
+    visit_labels(*ws, [&](const auto& lbls) { draw_ws_lines(lbls, res); });
 
   return res;
 }
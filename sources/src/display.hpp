@@ -10,4 +10,4 @@ enum {
 };
 
 mln::image2d<mln::rgb8> display(const mln::image2d<uint8_t>& input, std::span<scribo::LayoutRegion> regions,
-                                std::span<Segment> segments, mln::image2d<int16_t>* wslines, int display_options);
\ No newline at end of file
+                                std::span<Segment> segments, const mln::ndbuffer_image* wslines, int display_options);
\ No newline at end of file
@@ -131,7 +131,7 @@ namespace
   };
 
 
-  void gaussian1d(recursivefilter_coef_ c, float* input, std::ptrdiff_t size, float* tmp1, float* tmp2)
+  void gaussian1d(const recursivefilter_coef_& c, float* input, std::ptrdiff_t size, float* tmp1, float* tmp2)
   {
     tmp1[0] = c.n[0] * input[0];
 
@@ -217,12 +217,8 @@ namespace
 
 
   template <class T>
-  void gaussian2d_T(mln::image2d<T>& input, float h_sigma, float v_sigma, T border_value)
+  void gaussian2d_T(mln::image2d<T>& input, float h_sigma, float v_sigma, T border_value, std::vector<float>& tmp)
   {
-
-
-
-
     int b      = 5 * static_cast<int>(std::max(h_sigma, v_sigma) + 0.5f);
     int width  = input.width();
     int height = input.height();
@@ -230,7 +226,8 @@ namespace
     int tmp_size = std::max(width, height) + 2 * b;
 
     // Allocate temporary buffer
-    std::vector<float> tmp(3 * tmp_size);
+    if (tmp.size() < std::size_t(3 * tmp_size))
+      tmp.resize(3 * tmp_size);
     float*             i_buffer = tmp.data();
     float*             tmp1     = tmp.data() + tmp_size;
     float*             tmp2     = tmp.data() + 2 * tmp_size;
@@ -282,5 +279,22 @@ namespace
 
 void gaussian2d(mln::image2d<uint8_t>& input, float h_sigma, float v_sigma, uint8_t border_value)
 {
-  gaussian2d_T(input, h_sigma, v_sigma, border_value);
+  std::vector<float> scratch;
+  gaussian2d_T(input, h_sigma, v_sigma, border_value, scratch);
 }
+
+void gaussian2d(mln::image2d<uint8_t>& input, float h_sigma, float v_sigma, uint8_t border_value,
+                std::vector<float>& scratch)
+{
+  gaussian2d_T(input, h_sigma, v_sigma, border_value, scratch);
+}
+
+namespace details
+{
+  void gaussian1d(float* signal, std::ptrdiff_t size, float sigma, float* tmp)
+  {
+    recursivefilter_coef_ coef(1.68f, 3.735f, 1.783f, 1.723f, -0.6803f, -0.2598f, 0.6318f, 1.997f, sigma,
+                               recursivefilter_coef_::DericheGaussian);
+    ::gaussian1d(coef, signal, size, tmp, tmp + size);
+  }
+} // namespace details
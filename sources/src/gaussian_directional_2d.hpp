@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <vector>
 #include <mln/core/image/ndimage_fwd.hpp>
 
 
@@ -9,3 +11,16 @@
 /// \param h_sigma Horizontal stddev of the filter (0 to disable horizontal filtering)
 /// \param v_sigma Vertical stddev of the filter (0 to disable vertival filtering)
 void gaussian2d(mln::image2d<uint8_t>& input, float h_sigma, float v_sigma, uint8_t border_value);
+
+/// Same as above but the temporary buffers are taken from \p scratch (resized if needed) so that a thread can reuse
+/// them between calls
+void gaussian2d(mln::image2d<uint8_t>& input, float h_sigma, float v_sigma, uint8_t border_value,
+                std::vector<float>& scratch);
+
+
+namespace details
+{
+  /// Deriche gaussian filter of a 1D signal (in place, the padding of the signal is filtered as well). \p tmp holds
+  /// 2 * size floats.
+  void gaussian1d(float* signal, std::ptrdiff_t size, float sigma, float* tmp);
+} // namespace details
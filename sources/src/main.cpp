@@ -11,8 +11,11 @@
 #include "pdf_tool.hpp"
 
 #include "process.hpp"
+#include <EntryModel.hpp>
+#include <tracing.hpp>
 
 #include <fmt/format.h>
+#include <optional>
 #include <ranges>
 
 
@@ -46,6 +49,8 @@ int main(int argc, char** argv)
     std::string input_path;
     std::string json_format_path;
     std::string pages;
+    std::string entry_model_path;
+    std::string trace_path;
 
     params args;
 
@@ -55,6 +60,9 @@ int main(int argc, char** argv)
     app.add_flag("--denoise", args.denoising, "Force denoising (small components suppression). Enabled by default on B&W images");
     app.add_flag("!--no-denoise", args.denoising, "Disable denoising (small components suppression)");
     app.add_option("--ex", args.xheight, "Force the x-height (in pixels).");
+    app.add_flag("--kalman-segments{1}", args.segment_detector, "Detect the separators with the Kalman tracker instead of LSD (faster, long rules only)");
+    app.add_option("--entry-model", entry_model_path, "Load the entry classifier from a model file (JSON)")->check(CLI::ExistingFile);
+    app.add_option("--trace", trace_path, "Record the time spent in each stage as a Chrome trace (ex: trace.json)");
     app.add_option("--page", pages, "Set the pdf view number (accept ranges as in '151--1400').");
 
 
@@ -83,7 +91,7 @@ int main(int argc, char** argv)
 
     if (debug)
     {
-      kDebugLevel = debug;
+      args.debug = debug;
       spdlog::set_level(spdlog::level::debug);
     }
     else
@@ -91,6 +99,17 @@ int main(int argc, char** argv)
       spdlog::set_level(spdlog::level::warn);
     }
 
+    if (!trace_path.empty())
+      scribo::trace::enable();
+
+    // Loaded once and shared by all the pages
+    std::optional<scribo::EntryModel> entry_model;
+    if (!entry_model_path.empty())
+    {
+      entry_model = scribo::EntryModel::load(entry_model_path);
+      args.entry_model = &*entry_model;
+    }
+
 
    
   
@@ -115,4 +134,10 @@ int main(int argc, char** argv)
       process(input, aa);
     }
   }
+
+  if (!trace_path.empty())
+  {
+    std::ofstream trace_file(trace_path);
+    scribo::trace::write_chrome_trace(trace_file);
+  }
 }
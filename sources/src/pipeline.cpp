@@ -0,0 +1,184 @@
+#include <pipeline.hpp>
+#include <tracing.hpp>
+
+#include <mln/core/image/ndimage.hpp>
+#include <spdlog/spdlog.h>
+
+#include "config.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+
+namespace scribo
+{
+
+  auto process_page(const mln::image2d<uint8_t>& input, const page_options& options) -> page_result
+  {
+    scribo_entering("scribo::process_page", input.width(), input.height());
+    page_result res;
+
+    // 1. Cleaning
+    res.cleaning.xwidth  = options.xwidth;
+    res.cleaning.xheight = options.xheight;
+    res.cleaning.denoise = options.denoise;
+    res.clean = scribo::clean_document(input, res.cleaning, options.deskewed ? &res.deskewed : nullptr);
+
+    spdlog::info("[Cleaning] x-height: {}", res.cleaning.xheight);
+    spdlog::info("[Cleaning] x-width: {}", res.cleaning.xwidth);
+    spdlog::info("[Cleaning] Deskew angle: {}", res.cleaning.deskew_angle);
+    spdlog::info("[Cleaning] Denoising: {}", res.cleaning.denoise);
+
+    if (!options.layout)
+      return res;
+
+    // 2. Blocks
+    scribo::segment_detection_parameters sparams;
+    sparams.method = options.segment_detector;
+    res.segments   = scribo::extract_segments(input, sparams);
+    scribo::deskew_segments(res.segments, res.cleaning.deskew_angle);
+
+    auto config = options.config ? *options.config : KConfig();
+    config.set_xheight(res.cleaning.xheight, 1);
+
+    auto& regions = res.regions;
+    regions       = scribo::XYCutLayoutExtraction(res.clean, res.segments, config, options.n_threads);
+
+    // 3. Lines
+    std::vector<Box> text_boxes;
+    std::vector<int> text_boxes_ids;
+    for (std::size_t i = 0; i < regions.size(); ++i)
+      if (regions[i].type == DOMCategory::COLUMN_LEVEL_2)
+      {
+        text_boxes.push_back(regions[i].bbox);
+        text_boxes_ids.push_back(i);
+      }
+
+    int start = regions.size();
+    {
+      std::vector<scribo::LayoutRegion> line_regions;
+      res.ws = scribo::WSLineExtractionAnyLabel(res.clean, text_boxes, (config.kDebugLevel >= 2) ? "debug-ws" : "", config, &line_regions, options.n_threads);
+      for (auto&& t : line_regions)
+        t.parent_id = text_boxes_ids[t.parent_id];
+
+      std::ranges::copy(line_regions, std::back_inserter(regions));
+    }
+
+    // 4. Entries (all the columns at once)
+    scribo::EntryExtraction(std::span(regions.begin() + start, regions.end()), regions, options.entry_model);
+    return res;
+  }
+
+
+  void process_pages(std::span<const mln::image2d<uint8_t>> inputs, const page_options& options, int n_threads,
+                     const std::function<void(int, page_result&&)>& on_result)
+  {
+    int n       = (int)inputs.size();
+    int n_cores = std::max(1u, std::thread::hardware_concurrency());
+    if (n_threads <= 0)
+      n_threads = n_cores;
+    n_threads  = std::min(n_threads, n);
+    int window = 2 * n_threads;
+
+    // The pages share the cores (no oversubscription by the threads of the stages)
+    page_options page_opts = options;
+    if (page_opts.n_threads <= 0)
+      page_opts.n_threads = std::max(1, n_cores / std::max(n_threads, 1));
+
+    std::vector<std::optional<page_result>> results(n);
+    std::vector<std::exception_ptr>         errors(n);
+    std::vector<char>                       done(n, false);
+
+    // Protected by the mutex
+    std::mutex              mutex;
+    std::condition_variable cv;
+    int                     next_page   = 0; // Next page to start
+    int                     next_output = 0; // Next page to hand over
+    bool                    stop        = false;
+
+    auto worker = [&]() {
+      while (true)
+      {
+        int i;
+        {
+          std::unique_lock lock(mutex);
+          cv.wait(lock, [&] { return stop || next_page >= n || next_page < next_output + window; });
+          if (stop || next_page >= n)
+            return;
+          i = next_page++;
+        }
+
+        std::optional<page_result> r;
+        std::exception_ptr         e;
+        try
+        {
+          r = process_page(inputs[i], page_opts);
+        }
+        catch (...)
+        {
+          e = std::current_exception();
+        }
+
+        {
+          std::scoped_lock lock(mutex);
+          results[i] = std::move(r);
+          errors[i]  = e;
+          done[i]    = true;
+        }
+        cv.notify_all();
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for (int k = 0; k < n_threads; ++k)
+      threads.emplace_back(worker);
+
+    auto shutdown = [&]() {
+      {
+        std::scoped_lock lock(mutex);
+        stop = true;
+      }
+      cv.notify_all();
+      for (auto& t : threads)
+        t.join();
+    };
+
+    try
+    {
+      for (int i = 0; i < n; ++i)
+      {
+        page_result r;
+        {
+          std::unique_lock lock(mutex);
+          cv.wait(lock, [&] { return done[i] != 0; });
+          if (errors[i])
+          {
+            spdlog::error("Processing of the page {} failed.", i);
+            std::rethrow_exception(errors[i]);
+          }
+          r = std::move(*results[i]);
+          results[i].reset();
+        }
+
+        on_result(i, std::move(r));
+
+        {
+          std::scoped_lock lock(mutex);
+          next_output = i + 1;
+        }
+        cv.notify_all();
+      }
+    }
+    catch (...)
+    {
+      shutdown();
+      throw;
+    }
+    shutdown();
+  }
+
+} // namespace scribo
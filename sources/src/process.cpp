@@ -3,6 +3,7 @@
 
 #include <mln/core/image/ndimage.hpp>
 #include <scribo.hpp>
+#include <pipeline.hpp>
 #include <spdlog/spdlog.h>
 
 #include <mln/io/imsave.hpp>
@@ -31,79 +32,35 @@ void process(mln::ndbuffer_image _input, const params& params)
 
 
 
-    // 1. Cleaning
-    scribo::cleaning_parameters cparams;
-    cparams.xheight = params.xheight;
+    scribo::page_options options;
+    options.xheight          = params.xheight;
+    options.segment_detector = static_cast<scribo::segment_detection_parameters::Method>(params.segment_detector);
+    options.layout           = (params.json != nullptr);
+    options.deskewed         = !params.bg_suppression;
+    options.entry_model      = params.entry_model;
 
-    mln::image2d<uint8_t> deskewed;
-    auto clean = scribo::clean_document(input, cparams, params.bg_suppression ? nullptr : &deskewed);
+    auto config        = KConfig();
+    config.kDebugLevel = params.debug;
+    options.config     = &config;
 
-    spdlog::info("[Cleaning] x-height: {}", cparams.xheight);
-    spdlog::info("[Cleaning] x-width: {}", cparams.xwidth);
-    spdlog::info("[Cleaning] Deskew angle: {}", cparams.deskew_angle);
-    spdlog::info("[Cleaning] Denoising: {}", cparams.denoise);
+    auto res = scribo::process_page(input, options);
 
     if (!params.output_path.empty())
     {
       auto manifest_file = params.output_path.substr(0, params.output_path.find_last_of('.')).append("-manifest.json");
-      export_manifest(manifest_file.c_str(), cparams);
-      auto& exported = params.bg_suppression ? clean : deskewed;
+      export_manifest(manifest_file.c_str(), res.cleaning);
+      auto& exported = params.bg_suppression ? res.clean : res.deskewed;
       mln::io::imsave(exported, params.output_path);
     }
 
     if (params.json == nullptr)
       return;
 
-    // 2.
-
-    auto segments = scribo::extract_segments(input);
-    scribo::deskew_segments(segments, cparams.deskew_angle);
-    auto config  = KConfig(cparams.xheight, 1);
-    auto regions = scribo::XYCutLayoutExtraction(clean, segments, config);
-
-    std::vector<Box> text_boxes;
-    std::vector<int> text_boxes_ids;
-    for (std::size_t i = 0; i < regions.size(); ++i)
-      if (regions[i].type == DOMCategory::COLUMN_LEVEL_2)
-      {
-        text_boxes.push_back(regions[i].bbox);
-        text_boxes_ids.push_back(i);
-      }
-
-    mln::image2d<int16_t> ws;
-
-    {
-      int start = regions.size();
-      {
-        std::vector<scribo::LayoutRegion> line_regions;
-        ws = scribo::WSLineExtraction(clean, text_boxes, (kDebugLevel >= 2) ? "debug-ws" : "", config, &line_regions);
-        for (auto&& t : line_regions)
-          t.parent_id = text_boxes_ids[t.parent_id];
-
-        std::ranges::copy(line_regions, std::back_inserter(regions));
-        // mln::io::imsave(ws, "ws.tiff");
-      }
-
-      // Entry extraction
-      int end = regions.size();
-      regions.reserve(regions.size() * 2);
-      for (int i = start; i < end;)
-      {
-        auto q = regions[i].parent_id;
-        int  k = i;
-        while (i < end && regions[i].parent_id == q)
-          ++i;
-        if (k < i)
-          scribo::EntryExtraction(regions[q].bbox, std::span(regions.begin() + k, regions.begin() + i), regions);
-      }
-    }
-
-
-    auto disp = display(clean, regions, segments, &ws, params.display_opts);
+    auto disp = display(res.clean, res.regions, res.segments, &res.ws, params.display_opts);
 
     if (!params.output_layout_file.empty())
       mln::io::imsave(disp, params.output_layout_file);
 
     if (params.json != nullptr)
-      scribo::to_json(regions, *params.json);
-}
\ No newline at end of file
+      scribo::to_json(res.regions, *params.json);
+}
@@ -4,6 +4,11 @@
 #include <mln/core/image/ndimage_fwd.hpp>
 #include <cstdint>
 
+namespace scribo
+{
+  class EntryModel;
+}
+
 struct params
 {
     int display_opts = 0;
@@ -12,12 +17,14 @@ struct params
     bool bg_suppression = true;
     int debug = 0;
     int xheight = -1;
+    int segment_detector = 0;       // Segment detection method (see scribo::segment_detection_parameters::Method)
 
 
 
     std::string output_path;        // The path to save the cleaned/deskewed image
     std::string output_layout_file; // The path to save the layout **image** (debug purpose)
     std::ostream* json = nullptr;   // Stream to output the detected regions as a JSON stream
+    const scribo::EntryModel* entry_model = nullptr; // The entry classifier (the compiled-in model if null)
 };
 
 
@@ -1,44 +1,152 @@
 #include "scribo.hpp"
+#include "EntryModel.hpp"
+#include "pipeline.hpp"
 #include "config.hpp"
 #include "subsample.hpp"
 
 #include <spdlog/spdlog.h>
+#include <spdlog/sinks/base_sink.h>
+#include <spdlog/details/null_mutex.h>
 
 #include "CoreTypes.hpp"
 #include "DOMTypes.hpp"
 #include <mln/core/image/ndimage.hpp>
 #include <pln/image_cast.hpp>
 
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
-#include <pybind11/iostream.h>
+
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 
 namespace py = pybind11;
 
-namespace scribo
+namespace
 {
-  /// \brief This function is not thread-safe
-  void set_debug_level(int debug_level) noexcept
+  // Forward the C++ logs to the python logger "scribocxx". The messages logged by a thread that holds the GIL are
+  // forwarded at once. The others (threads of the library while a binding has released the GIL) are queued without
+  // taking the GIL, and forwarded when the GIL is taken back (see release_gil) or with the next message logged under
+  // the GIL.
+  class python_logging_sink final : public spdlog::sinks::base_sink<spdlog::details::null_mutex>
   {
-    kDebugLevel = debug_level;
-    if (debug_level == 0)
-      spdlog::set_level(spdlog::level::level_enum::info);
-    else
-      spdlog::set_level(spdlog::level::level_enum::debug);
-  }
-
-  int  get_debug_level() noexcept { return kDebugLevel; }
-
+  public:
+    python_logging_sink() { set_pattern_("%v"); }
+
+    // Forward the queued messages (the GIL must be held)
+    void forward_pending()
+    {
+      std::vector<std::pair<int, std::string>> pending;
+      {
+        std::scoped_lock lock(m_mutex);
+        pending.swap(m_pending);
+      }
+      for (const auto& [level, txt] : pending)
+        forward(level, txt);
+    }
+
+  protected:
+    void sink_it_(const spdlog::details::log_msg& msg) override
+    {
+      if (!Py_IsInitialized())
+        return;
+
+      spdlog::memory_buf_t buf;
+      {
+        std::scoped_lock lock(m_mutex); // The formatter is not thread-safe
+        formatter_->format(msg, buf);
+      }
+      std::string_view txt(buf.data(), buf.size());
+      while (!txt.empty() && (txt.back() == '\n' || txt.back() == '\r'))
+        txt.remove_suffix(1);
+
+      int level;
+      switch (msg.level)
+      {
+      case spdlog::level::trace:
+      case spdlog::level::debug: level = 10; break;
+      case spdlog::level::info: level = 20; break;
+      case spdlog::level::warn: level = 30; break;
+      case spdlog::level::err: level = 40; break;
+      default: level = 50; break;
+      }
+
+      if (!PyGILState_Check())
+      {
+        std::scoped_lock lock(m_mutex);
+        m_pending.emplace_back(level, std::string(txt));
+        return;
+      }
+
+      forward_pending();
+      forward(level, txt);
+    }
+
+    void flush_() override {}
+
+  private:
+    static void forward(int level, std::string_view txt)
+    {
+      try
+      {
+        py::module_::import("logging").attr("getLogger")("scribocxx").attr("log")(level, py::str(txt.data(), txt.size()));
+      }
+      catch (py::error_already_set& e)
+      {
+        e.discard_as_unraisable("scribocxx logging");
+      }
+    }
+
+    std::mutex                               m_mutex;
+    std::vector<std::pair<int, std::string>> m_pending;
+  };
+
+  python_logging_sink* g_python_sink = nullptr; // Owned by the default logger
+
+  // Release the GIL in a scope (or for a binding with py::call_guard). The messages logged meanwhile are forwarded
+  // once the GIL is taken back.
+  struct release_gil
+  {
+    struct forward_logs
+    {
+      ~forward_logs()
+      {
+        if (g_python_sink)
+          g_python_sink->forward_pending();
+      }
+    } logs;
+    py::gil_scoped_release nogil; // Destroyed first
+  };
+
+  // Attribute of KConfig that reads the default value when accessed from the class (KConfig.kAngleTolerance, as
+  // when the tunables were static), and the value of the instance otherwise. A value assigned to the class is not used
+  // by the pipeline: set it on an instance and pass the instance.
+  struct kconfig_default_attribute
+  {
+    py::object property; // The instance attribute (def_readwrite)
+    py::object defaults; // KConfig()
+  };
+} // namespace
 
-  std::vector<Segment> _extract_segments(mln::ndbuffer_image input)
+namespace scribo
+{
+  std::vector<Segment> _extract_segments(mln::ndbuffer_image input, int n_bands,
+                                         segment_detection_parameters::Method method)
   {
     auto img = input.cast_to<std::uint8_t, 2>();
     if (!img)
       throw std::runtime_error("Unable to cast the input image");
 
 
-    [[maybe_unused]] py::call_guard<py::scoped_ostream_redirect, py::scoped_estream_redirect> _g;
-    return extract_segments(*img);
+    release_gil nogil;
+    scribo::segment_detection_parameters params;
+    params.method  = method;
+    params.n_bands = n_bands;
+    return extract_segments(*img, params);
   }
 
 
@@ -48,7 +156,7 @@ namespace scribo
     if (!img_in)
       throw std::runtime_error("Unable to cast the input/output image");
 
-    [[maybe_unused]] py::call_guard<py::scoped_ostream_redirect, py::scoped_estream_redirect> _g;
+    release_gil nogil;
     return deskew_image(*img_in, angle);
   }
 
@@ -65,7 +173,7 @@ namespace scribo
     if (!img)
       throw std::runtime_error("Unable to cast the input/output image");
 
-    [[maybe_unused]] py::call_guard<py::scoped_ostream_redirect, py::scoped_estream_redirect> _g;
+    release_gil nogil;
     background_substraction_inplace(*img, kMinDiameter, kMinWidth, kMinHeight, kMinGrayLevel, kOpeningRadius, debug_prefix);
   }
 
@@ -76,13 +184,16 @@ namespace scribo
     if (!img)
       throw std::runtime_error("Unable to cast the input/output image");
 
-    [[maybe_unused]] py::call_guard<py::scoped_ostream_redirect, py::scoped_estream_redirect> _g;
     scribo::cleaning_parameters params {
       .xwidth = xwidth,
       .xheight = xheight,
       .denoise = denoise
     };
-    auto result = scribo::clean_document(*img, params);
+    mln::ndbuffer_image result;
+    {
+      release_gil nogil;
+      result = scribo::clean_document(*img, params);
+    }
 
     py::dict res;
     res["xwidth"] = params.xwidth;
@@ -109,7 +220,7 @@ namespace scribo
     if (!img)
       throw std::runtime_error("Unable to cast the input/output image");
 
-    [[maybe_unused]] py::call_guard<py::scoped_ostream_redirect, py::scoped_estream_redirect> _g;
+    release_gil nogil;
     return XYCutLayoutExtraction(*img, std::span{segments.begin(), segments.end()}, config);
   }
 
@@ -122,19 +233,26 @@ namespace scribo
     if (!img)
       throw std::runtime_error("Unable to cast the input/output image");
 
-    [[maybe_unused]] py::call_guard<py::scoped_ostream_redirect, py::scoped_estream_redirect> _g;
+    release_gil nogil;
     std::vector<LayoutRegion> bboxes;
-    mln::ndbuffer_image ws = WSLineExtraction(*img, std::span{regions.begin(), regions.end()}, debug_path, config, &bboxes);
+    mln::ndbuffer_image ws = WSLineExtractionAnyLabel(*img, std::span{regions.begin(), regions.end()}, debug_path, config, &bboxes);
     return std::make_pair(ws, std::move(bboxes));
   }
 
   std::pair<std::vector<LayoutRegion>, std::vector<LayoutRegion>> _EntryExtraction(Box region, std::vector<LayoutRegion> lines, std::vector<LayoutRegion> regionset)
   {
-    [[maybe_unused]] py::call_guard<py::scoped_ostream_redirect, py::scoped_estream_redirect> _g;
+    release_gil nogil;
     EntryExtraction(region, lines, regionset);
     return std::make_pair(regionset, lines);
   }
 
+  std::pair<std::vector<LayoutRegion>, std::vector<LayoutRegion>> _EntryExtractionBatch(std::vector<LayoutRegion> lines, std::vector<LayoutRegion> regionset, const EntryModel* model)
+  {
+    release_gil nogil;
+    EntryExtraction(lines, regionset, model);
+    return std::make_pair(regionset, lines);
+  }
+
 
   /// \brief
   auto _TesseractTextExtraction(mln::ndbuffer_image input, std::vector<Box> regions,
@@ -144,9 +262,148 @@ namespace scribo
     if (!img)
       throw std::runtime_error("Unable to cast the input/output image");
 
-    [[maybe_unused]] py::call_guard<py::scoped_ostream_redirect, py::scoped_estream_redirect> _g;
+    release_gil nogil;
     return TesseractTextExtraction(*img, std::span{regions.begin(), regions.end()}, is_line);
   }
+
+  /// \brief Same as _TesseractTextExtraction() but also returns the lines and words (boxes and confidences)
+  auto _TesseractTextExtractionWithBoxes(mln::ndbuffer_image input, std::vector<Box> regions, bool is_line = false)
+      -> std::pair<std::vector<std::string>, std::vector<OCRBox>>
+  {
+    mln::image2d<uint8_t>* img = input.cast_to<std::uint8_t, 2>();
+    if (!img)
+      throw std::runtime_error("Unable to cast the input/output image");
+
+    release_gil nogil;
+    std::vector<OCRBox> boxes;
+    auto texts = TesseractTextExtraction(*img, std::span{regions.begin(), regions.end()}, is_line, &boxes);
+    return std::make_pair(std::move(texts), std::move(boxes));
+  }
+
+  // A LayoutRegion is exported as a record of 7 int32 (x, y, w, h, type, parent_id, mask_instance_id) that matches its
+  // memory layout, so that a vector of regions can be viewed as a numpy structured array without copy.
+  static_assert(std::is_standard_layout_v<LayoutRegion> && std::is_standard_layout_v<Box>);
+  static_assert(sizeof(DOMCategory) == sizeof(int32_t) && sizeof(LayoutRegion) == 7 * sizeof(int32_t));
+
+  py::dtype region_dtype()
+  {
+    py::list names, formats, offsets;
+    auto     add = [&](const char* name, std::size_t offset) {
+      names.append(name);
+      formats.append("<i4");
+      offsets.append(offset);
+    };
+    add("x", offsetof(LayoutRegion, bbox) + offsetof(Box, x));
+    add("y", offsetof(LayoutRegion, bbox) + offsetof(Box, y));
+    add("w", offsetof(LayoutRegion, bbox) + offsetof(Box, width));
+    add("h", offsetof(LayoutRegion, bbox) + offsetof(Box, height));
+    add("type", offsetof(LayoutRegion, type));
+    add("parent_id", offsetof(LayoutRegion, parent_id));
+    add("mask_instance_id", offsetof(LayoutRegion, mask_instance_id));
+    return py::dtype(names, formats, offsets, sizeof(LayoutRegion));
+  }
+
+  /// \brief View the regions as a numpy structured array. The buffer is moved into a capsule owned by the array.
+  py::array _regions_to_array(std::vector<LayoutRegion> regions)
+  {
+    auto*       buffer = new std::vector<LayoutRegion>(std::move(regions));
+    py::capsule owner(buffer, [](void* p) { delete static_cast<std::vector<LayoutRegion>*>(p); });
+    return py::array(region_dtype(), {(py::ssize_t)buffer->size()}, {(py::ssize_t)sizeof(LayoutRegion)}, buffer->data(),
+                     owner);
+  }
+
+  /// \brief Inverse of _regions_to_array()
+  std::vector<LayoutRegion> _regions_from_array(py::array input)
+  {
+    if (!input.dtype().equal(region_dtype()) || input.ndim() != 1)
+      throw std::invalid_argument("Expected a 1D array with the dtype of scribocxx.region_dtype");
+
+    auto arr = py::array::ensure(input, py::array::c_style);
+    std::vector<LayoutRegion> regions(arr.shape(0));
+    std::memcpy(regions.data(), arr.data(), regions.size() * sizeof(LayoutRegion));
+    return regions;
+  }
+
+  /// \brief Same as _EntryExtractionBatch() on region arrays
+  auto _EntryExtractionBatchArray(py::array lines, py::array regionset, const EntryModel* model) -> std::pair<py::array, py::array>
+  {
+    auto l = _regions_from_array(lines);
+    auto r = _regions_from_array(regionset);
+    {
+      release_gil nogil;
+      EntryExtraction(l, r, model);
+    }
+    return {_regions_to_array(std::move(r)), _regions_to_array(std::move(l))};
+  }
+
+  // Conversion of a pipeline result (the GIL must be held)
+  py::tuple _page_result_to_tuple(page_result&& res, const page_options& options)
+  {
+    py::dict params;
+    params["xwidth"]       = res.cleaning.xwidth;
+    params["xheight"]      = res.cleaning.xheight;
+    params["deskew_angle"] = res.cleaning.deskew_angle;
+    params["denoise"]      = res.cleaning.denoise;
+
+    py::object ws = py::none();
+    if (options.layout)
+      ws = py::cast(std::move(res.ws));
+
+    return py::make_tuple(mln::ndbuffer_image(std::move(res.clean)), ws, _regions_to_array(std::move(res.regions)), params);
+  }
+
+  /// \brief Whole pipeline (see process_page())
+  /// \return (clean image, watershed labels, region array, cleaning parameters)
+  py::tuple _process_page(mln::ndbuffer_image input, const page_options& options)
+  {
+    mln::image2d<uint8_t>* img = input.cast_to<std::uint8_t, 2>();
+    if (!img)
+      throw std::runtime_error("Unable to cast the input image");
+
+    page_result res;
+    {
+      release_gil nogil;
+      res = process_page(*img, options);
+    }
+    return _page_result_to_tuple(std::move(res), options);
+  }
+
+  /// \brief Whole pipeline on several pages (see process_pages())
+  ///
+  /// Without callback, return the list of the results (as in _process_page()). Otherwise, `callback(index, result)` is
+  /// called for each page in order as soon as it is available and the result is not kept.
+  py::object _process_pages(std::vector<mln::ndbuffer_image> inputs, const page_options& options, int n_threads,
+                            py::object callback)
+  {
+    std::vector<mln::image2d<uint8_t>> images;
+    images.reserve(inputs.size());
+    for (auto& input : inputs)
+    {
+      mln::image2d<uint8_t>* img = input.cast_to<std::uint8_t, 2>();
+      if (!img)
+        throw std::runtime_error("Unable to cast the input image");
+      images.push_back(*img);
+    }
+
+    py::list out;
+    {
+      release_gil nogil;
+      process_pages(images, options, n_threads, [&](int i, page_result&& res) {
+        py::gil_scoped_acquire gil;
+        if (g_python_sink)
+          g_python_sink->forward_pending();
+        auto t = _page_result_to_tuple(std::move(res), options);
+        if (callback.is_none())
+          out.append(t);
+        else
+          callback(i, t);
+      });
+    }
+
+    if (callback.is_none())
+      return out;
+    return py::none();
+  }
 } // namespace scribo
 
 
@@ -157,25 +414,83 @@ PYBIND11_MODULE(scribocxx, m)
   pln::init_pylena_numpy(m);
   m.doc() = "A simple cpp image manipulator package";
 
+  auto sink     = std::make_shared<python_logging_sink>();
+  g_python_sink = sink.get();
+  spdlog::set_default_logger(std::make_shared<spdlog::logger>("scribocxx", std::move(sink)));
+
   py::class_<KConfig>(m, "KConfig")
+    .def(py::init<>())
     .def(py::init<int, int>())
+    .def("set_xheight", &KConfig::set_xheight)
     .def_readwrite("kLineHeight", &KConfig::kLineHeight)
     .def_readwrite("kWordSpacing", &KConfig::kWordSpacing)
     .def_readwrite("kWordWidth", &KConfig::kWordWidth)
     .def_readwrite("kOneEm", &KConfig::kOneEm)
-    .def_readwrite_static("kLineHorizontalSigma", &KConfig::kLineHorizontalSigma)
-    .def_readwrite_static("kLineVerticalSigma", &KConfig::kLineVerticalSigma)
-    .def_readwrite_static("kAngleTolerance", &KConfig::kAngleTolerance)
-    .def_readwrite_static("kLayoutPageOpeningWidth", &KConfig::kLayoutPageOpeningWidth)
-    .def_readwrite_static("kLayoutPageOpeningHeight", &KConfig::kLayoutPageOpeningHeight)
-    .def_readwrite_static("kLayoutPageFullLineWhite", &KConfig::kLayoutPageFullLineWhite)
-    .def_readwrite_static("kLayoutPageMargin", &KConfig::kLayoutPageMargin)
-    .def_readwrite_static("kLayoutWhiteLevel", &KConfig::kLayoutWhiteLevel)
-    .def_readwrite_static("kLayoutBlockFillingRatio", &KConfig::kLayoutBlockFillingRatio)
+    .def_readwrite("kLineHorizontalSigma", &KConfig::kLineHorizontalSigma)
+    .def_readwrite("kLineVerticalSigma", &KConfig::kLineVerticalSigma)
+    .def_readwrite("kAngleTolerance", &KConfig::kAngleTolerance)
+    .def_readwrite("kLayoutPageOpeningWidth", &KConfig::kLayoutPageOpeningWidth)
+    .def_readwrite("kLayoutPageOpeningHeight", &KConfig::kLayoutPageOpeningHeight)
+    .def_readwrite("kLayoutPageFullLineWhite", &KConfig::kLayoutPageFullLineWhite)
+    .def_readwrite("kLayoutPageMargin", &KConfig::kLayoutPageMargin)
+    .def_readwrite("kLayoutWhiteLevel", &KConfig::kLayoutWhiteLevel)
+    .def_readwrite("kLayoutBlockFillingRatio", &KConfig::kLayoutBlockFillingRatio)
     .def_readwrite("kLayoutBlockOpeningWidth", &KConfig::kLayoutBlockOpeningWidth)
     .def_readwrite("kLayoutBlockOpeningHeight", &KConfig::kLayoutBlockOpeningHeight)
     .def_readwrite("kLayoutBlockMinHeight", &KConfig::kLayoutBlockMinHeight)
     .def_readwrite("kLayoutBlockMinWidth", &KConfig::kLayoutBlockMinWidth)
+    .def_readwrite("kDebugLevel", &KConfig::kDebugLevel)
+    ;
+
+  py::class_<kconfig_default_attribute>(m, "_KConfigDefaultAttribute")
+    .def("__get__", [](const kconfig_default_attribute& self, py::object obj, py::object) {
+      return self.property.attr("__get__")(obj.is_none() ? self.defaults : obj);
+    })
+    .def("__set__", [](const kconfig_default_attribute& self, py::object obj, py::object value) {
+      self.property.attr("__set__")(obj, value);
+    })
+    ;
+
+  {
+    py::object cls      = m.attr("KConfig");
+    py::object defaults = cls();
+    for (const char* name : {"kLineHorizontalSigma", "kLineVerticalSigma", "kAngleTolerance", "kLayoutPageOpeningWidth",
+                             "kLayoutPageOpeningHeight", "kLayoutPageFullLineWhite", "kLayoutPageMargin",
+                             "kLayoutWhiteLevel", "kLayoutBlockFillingRatio"})
+      py::setattr(cls, name, py::cast(kconfig_default_attribute{cls.attr(name), defaults}));
+  }
+
+  py::class_<scribo::EntryModel>(m, "EntryModel")
+    .def(py::init<>())
+    .def_static("load", py::overload_cast<const std::string&>(&scribo::EntryModel::load))
+    ;
+
+  m.attr("region_dtype") = scribo::region_dtype();
+
+  py::enum_<scribo::segment_detection_parameters::Method>(m, "SegmentDetectionMethod")
+      .value("LSD", scribo::segment_detection_parameters::LSD)
+      .value("KALMAN", scribo::segment_detection_parameters::KALMAN);
+
+
+  py::class_<scribo::page_options>(m, "PageOptions")
+    .def(py::init<>())
+    .def_readwrite("xwidth", &scribo::page_options::xwidth)
+    .def_readwrite("xheight", &scribo::page_options::xheight)
+    .def_readwrite("denoise", &scribo::page_options::denoise)
+    .def_readwrite("segment_detector", &scribo::page_options::segment_detector)
+    .def_readwrite("layout", &scribo::page_options::layout)
+    // The options only hold pointers: the setters keep the assigned objects alive (a call policy is only applied by
+    // the function it is built with, not by def_property)
+    .def_property("entry_model",
+                  [](const scribo::page_options& o) { return o.entry_model; },
+                  py::cpp_function([](scribo::page_options& o, const scribo::EntryModel* m) { o.entry_model = m; },
+                                   py::keep_alive<1, 2>()),
+                  py::return_value_policy::reference)
+    .def_property("config",
+                  [](const scribo::page_options& o) { return o.config; },
+                  py::cpp_function([](scribo::page_options& o, const KConfig* c) { o.config = c; },
+                                   py::keep_alive<1, 2>()),
+                  py::return_value_policy::reference)
     ;
 
   py::class_<Point2D>(m, "Point2D")
@@ -255,20 +570,31 @@ PYBIND11_MODULE(scribocxx, m)
     ;
 
 
-  m.def("_extract_segments", &scribo::_extract_segments)
-      .def("_deskew_segments", &scribo::deskew_segments)
+  m.def("_extract_segments", &scribo::_extract_segments, py::arg("input"), py::arg("n_bands") = 1,
+           py::arg("method") = scribo::segment_detection_parameters::LSD)
+      .def("_deskew_segments", &scribo::deskew_segments, py::call_guard<release_gil>())
       .def("_deskew_image", &scribo::_deskew_image)
       .def("_clean_document", &scribo::_clean_document)
-      .def("_deskew_estimation", &scribo::deskew_estimation)
-      .def("_deskew_segments", &scribo::deskew_segments)
+      .def("_deskew_estimation", &scribo::deskew_estimation, py::call_guard<release_gil>())
       .def("_background_substraction_inplace", &scribo::_background_substraction_inplace)
       .def("_XYCutLayoutExtraction", &scribo::_XYCutLayoutExtraction)
       .def("_WSLineExtraction", &scribo::_WSLineExtraction)
       .def("_EntryExtraction", &scribo::_EntryExtraction)
+      .def("_EntryExtractionBatch", &scribo::_EntryExtractionBatchArray,
+           py::arg("lines").noconvert(), py::arg("regionset").noconvert(), py::arg("model") = nullptr)
+      .def("_EntryExtractionBatch", &scribo::_EntryExtractionBatch,
+           py::arg("lines"), py::arg("regionset"), py::arg("model") = nullptr)
+      .def("regions_to_array", &scribo::_regions_to_array)
+      .def("regions_from_array", &scribo::_regions_from_array)
       .def("_TesseractTextExtraction", &scribo::_TesseractTextExtraction,
            py::arg("input"), py::arg("regions"), py::arg("is_line") = false)
+      .def("_TesseractTextExtractionWithBoxes", &scribo::_TesseractTextExtractionWithBoxes,
+           py::arg("input"), py::arg("regions"), py::arg("is_line") = false)
+      .def("process_page", &scribo::_process_page, py::arg("input"), py::arg("options") = scribo::page_options{})
+      .def("process_pages", &scribo::_process_pages, py::arg("inputs"), py::arg("options") = scribo::page_options{},
+           py::arg("n_threads") = 0, py::arg("callback") = py::none())
       .def("_set_debug_level", &scribo::set_debug_level)
-      .def("_subsample", &scribo::_subsample);
+      .def("_subsample", &scribo::_subsample, py::call_guard<release_gil>());
 
   py::enum_<scribo::DOMCategory>(m, "DOMCategory")
       .value("PAGE", DOMCategory::PAGE)
@@ -283,6 +609,19 @@ PYBIND11_MODULE(scribocxx, m)
       .export_values();
 
 
+  py::enum_<scribo::OCRLevel>(m, "OCRLevel")
+      .value("LINE", scribo::OCRLevel::LINE)
+      .value("WORD", scribo::OCRLevel::WORD);
+
+  py::class_<scribo::OCRBox>(m, "OCRBox")
+    .def_readonly("region_id", &scribo::OCRBox::region_id)
+    .def_readonly("level", &scribo::OCRBox::level)
+    .def_readonly("bbox", &scribo::OCRBox::bbox)
+    .def_readonly("confidence", &scribo::OCRBox::confidence)
+    .def_readonly("text", &scribo::OCRBox::text)
+    ;
+
+
   py::enum_<e_force_indent>(m, "ForceIndent")
       .value("FORCE_NONE", e_force_indent::FORCE_NONE)
       .value("FORCE_LEFT", e_force_indent::FORCE_LEFT)
@@ -1,8 +1,15 @@
 #include "signal.hpp"
 
 #include <mln/core/image/ndimage.hpp>
-#include <mln/core/range/foreach.hpp>
 #include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+// AVX2 kernels are compiled with a target attribute and selected at runtime
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define SCRIBO_HAS_AVX2_DISPATCH
+#include <immintrin.h>
+#endif
 
 std::vector<int> find_peaks(std::span<const float> count)
 {
@@ -92,24 +99,151 @@ std::vector<std::pair<int, int>> partitions(std::span<const int> data, int thres
     return split_section_T(data, min_seperator_size, min_section_size, [threshold](int x) { return x >= threshold; });
 }
 
+namespace
+{
+  // Number of black pixels of each row
+  void count_rows_scalar(const uint8_t* buffer, std::ptrdiff_t stride, int width, int height, int white_level, int* out)
+  {
+    for (int y = 0; y < height; ++y, buffer += stride)
+    {
+      int c = 0;
+      for (int x = 0; x < width; ++x)
+        c += (buffer[x] < white_level);
+      out[y] = c;
+    }
+  }
+
+  // Number of black pixels of each column. Rows are accumulated in 16-bit counters flushed every 65535 rows
+  void count_columns_scalar(const uint8_t* buffer, std::ptrdiff_t stride, int width, int height, int white_level,
+                            int* out)
+  {
+    std::vector<uint16_t> acc(width);
+    std::fill_n(out, width, 0);
+    for (int y0 = 0; y0 < height; y0 += UINT16_MAX)
+    {
+      int y1 = std::min(height, y0 + UINT16_MAX);
+      std::fill(acc.begin(), acc.end(), 0);
+      for (int y = y0; y < y1; ++y, buffer += stride)
+        for (int x = 0; x < width; ++x)
+          acc[x] += (buffer[x] < white_level);
+      for (int x = 0; x < width; ++x)
+        out[x] += acc[x];
+    }
+  }
+
+#if defined(SCRIBO_HAS_AVX2_DISPATCH)
+  // Returns 0xFF for the bytes of v that are < white_level (1 <= white_level <= 255)
+  __attribute__((target("avx2"))) inline __m256i is_black_avx2(__m256i v, __m256i max_black)
+  {
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(v, max_black), v);
+  }
+
+  // Compare and horizontal add. The byte counters are reduced every 255 vectors.
+  __attribute__((target("avx2"))) void count_rows_avx2(const uint8_t* buffer, std::ptrdiff_t stride, int width,
+                                                       int height, int white_level, int* out)
+  {
+    if (white_level <= 0 || white_level > UINT8_MAX)
+      return count_rows_scalar(buffer, stride, width, height, white_level, out);
+
+    const __m256i max_black = _mm256_set1_epi8(static_cast<char>(white_level - 1));
+    const __m256i zero      = _mm256_setzero_si256();
+    const int     n         = width & ~31;
+
+    for (int y = 0; y < height; ++y, buffer += stride)
+    {
+      __m256i sum = zero;
+      int     x   = 0;
+      while (x < n)
+      {
+        __m256i acc  = zero;
+        int     xend = std::min(n, x + 255 * 32);
+        for (; x < xend; x += 32)
+        {
+          __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buffer + x));
+          acc       = _mm256_sub_epi8(acc, is_black_avx2(v, max_black)); // acc += 1 for each black pixel
+        }
+        sum = _mm256_add_epi64(sum, _mm256_sad_epu8(acc, zero));
+      }
+      int c = static_cast<int>(_mm256_extract_epi64(sum, 0) + _mm256_extract_epi64(sum, 1) +
+                               _mm256_extract_epi64(sum, 2) + _mm256_extract_epi64(sum, 3));
+      for (; x < width; ++x)
+        c += (buffer[x] < white_level);
+      out[y] = c;
+    }
+  }
+
+  // Vertical adds over the rows in 16-bit lanes flushed every 65535 rows
+  __attribute__((target("avx2"))) void count_columns_avx2(const uint8_t* buffer, std::ptrdiff_t stride, int width,
+                                                          int height, int white_level, int* out)
+  {
+    if (white_level <= 0 || white_level > UINT8_MAX)
+      return count_columns_scalar(buffer, stride, width, height, white_level, out);
+
+    const __m256i max_black = _mm256_set1_epi8(static_cast<char>(white_level - 1));
+    const __m256i one       = _mm256_set1_epi8(1);
+    const int     n         = width & ~31;
+
+    std::vector<uint16_t> acc(width);
+    std::fill_n(out, width, 0);
+    for (int y0 = 0; y0 < height; y0 += UINT16_MAX)
+    {
+      int y1 = std::min(height, y0 + UINT16_MAX);
+      std::fill(acc.begin(), acc.end(), 0);
+      for (int y = y0; y < y1; ++y, buffer += stride)
+      {
+        int x = 0;
+        for (; x < n; x += 32)
+        {
+          __m256i v    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buffer + x));
+          __m256i b    = _mm256_and_si256(is_black_avx2(v, max_black), one);
+          __m256i lo   = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(b));
+          __m256i hi   = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(b, 1));
+          auto*   ptr  = reinterpret_cast<__m256i*>(acc.data() + x);
+          _mm256_storeu_si256(ptr, _mm256_add_epi16(_mm256_loadu_si256(ptr), lo));
+          _mm256_storeu_si256(ptr + 1, _mm256_add_epi16(_mm256_loadu_si256(ptr + 1), hi));
+        }
+        for (; x < width; ++x)
+          acc[x] += (buffer[x] < white_level);
+      }
+      for (int x = 0; x < width; ++x)
+        out[x] += acc[x];
+    }
+  }
+#endif
+} // namespace
+
+namespace details
+{
+  // Select the kernels supported by the CPU (once)
+  const black_pixel_kernels& black_pixel_counters(bool simd)
+  {
+    static const black_pixel_kernels scalar = {count_rows_scalar, count_columns_scalar};
+    static const black_pixel_kernels k      = [] {
+#if defined(SCRIBO_HAS_AVX2_DISPATCH)
+      if (__builtin_cpu_supports("avx2"))
+        return black_pixel_kernels{count_rows_avx2, count_columns_avx2};
+#endif
+      return scalar;
+    }();
+    return simd ? k : scalar;
+  }
+} // namespace details
+
 void is_number_of_black_pixels_less_than(mln::image2d<uint8_t> input, int white_level, int threshold,
                                          Axis axis, uint8_t* out)
 {
-  std::vector<int> count;
+  const auto& k = details::black_pixel_counters();
 
+  std::vector<int> count;
   if (axis == Axis::Y)
   {
-    int x0 = input.domain().x();
-    count.resize(input.width(), 0);
-    mln_foreach (auto px, input.pixels())
-      count[px.point().x() - x0] += (px.val() < white_level);
+    count.resize(input.width());
+    k.columns(input.buffer(), input.stride(), input.width(), input.height(), white_level, count.data());
   }
   else
   {
-    int y0 = input.domain().y();
-    count.resize(input.height(), 0);
-    mln_foreach (auto px, input.pixels())
-      count[px.point().y() - y0] += (px.val() < white_level);
+    count.resize(input.height());
+    k.rows(input.buffer(), input.stride(), input.width(), input.height(), white_level, count.data());
   }
 
   std::transform(std::begin(count), std::end(count), out, [threshold](int c) { return c < threshold; });
@@ -130,4 +264,78 @@ std::vector<uint8_t> is_number_of_black_pixels_less_than(mln::image2d<uint8_t> i
   out.resize((axis == Axis::Y) ? input.width() : input.height());
   is_number_of_black_pixels_less_than(input, white_level, percentile, axis, out.data());
   return out;
-}
\ No newline at end of file
+}
+
+
+BlackPixelTable::BlackPixelTable(const mln::image2d<uint8_t>& input, int white_level)
+  : m_domain{input.domain()}
+{
+  const int w = input.width();
+  const int h = input.height();
+  const int n = w + 1;
+
+  m_sums.assign(static_cast<std::size_t>(n) * (h + 1), 0);
+
+  const uint8_t* lineptr = input.buffer();
+  for (int y = 0; y < h; ++y)
+  {
+    const uint16_t* prev = m_sums.data() + y * n;
+    uint16_t*       cur  = m_sums.data() + (y + 1) * n;
+    uint16_t        acc  = 0;
+    for (int x = 0; x < w; ++x)
+    {
+      acc += (lineptr[x] < white_level);
+      cur[x + 1] = prev[x + 1] + acc;
+    }
+    lineptr += input.stride();
+  }
+}
+
+void BlackPixelTable::count(mln::box2d roi, Axis axis, int* out) const
+{
+  const int n  = m_domain.width() + 1;
+  const int x0 = roi.x() - m_domain.x();
+  const int y0 = roi.y() - m_domain.y();
+  const int x1 = x0 + roi.width();
+  const int y1 = y0 + roi.height();
+
+  assert(0 <= x0 && x1 <= m_domain.width() && 0 <= y0 && y1 <= m_domain.height());
+
+  // Sums wrap around, the differences are exact once truncated to 16 bits
+  auto S = [&](int x, int y) { return m_sums[y * n + x]; };
+  if (axis == Axis::Y)
+  {
+    for (int x = x0; x < x1; ++x)
+      out[x - x0] = static_cast<uint16_t>(S(x + 1, y1) - S(x, y1) - S(x + 1, y0) + S(x, y0));
+  }
+  else
+  {
+    for (int y = y0; y < y1; ++y)
+      out[y - y0] = static_cast<uint16_t>(S(x1, y + 1) - S(x0, y + 1) - S(x1, y) + S(x0, y));
+  }
+}
+
+void is_number_of_black_pixels_less_than(const BlackPixelTable& table, mln::box2d roi, int threshold, Axis axis,
+                                         uint8_t* out)
+{
+  std::vector<int> count((axis == Axis::Y) ? roi.width() : roi.height());
+  table.count(roi, axis, count.data());
+  std::transform(std::begin(count), std::end(count), out, [threshold](int c) { return c < threshold; });
+}
+
+void is_number_of_black_pixels_less_than(const BlackPixelTable& table, mln::box2d roi, float percentile, Axis axis,
+                                         uint8_t* out)
+{
+  int n  = (axis == Axis::Y) ? roi.height() : roi.width();
+  int np = int(percentile * n);
+  is_number_of_black_pixels_less_than(table, roi, np, axis, out);
+}
+
+std::vector<uint8_t> is_number_of_black_pixels_less_than(const BlackPixelTable& table, mln::box2d roi,
+                                                         float percentile, Axis axis)
+{
+  std::vector<uint8_t> out;
+  out.resize((axis == Axis::Y) ? roi.width() : roi.height());
+  is_number_of_black_pixels_less_than(table, roi, percentile, axis, out.data());
+  return out;
+}
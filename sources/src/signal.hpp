@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <span>
 #include <vector>
 #include <mln/core/image/ndimage.hpp>
@@ -51,4 +53,57 @@ void is_number_of_black_pixels_less_than(mln::image2d<uint8_t> input, int white_
 
 
 std::vector<uint8_t> is_number_of_black_pixels_less_than(mln::image2d<uint8_t> input, int white_level, float percentile,
-                                                         Axis axis);
\ No newline at end of file
+                                                         Axis axis);
+
+
+namespace details
+{
+  // Black pixel counting kernels
+  // A pixel is black if its value is < white_level. Both kernels are given the first pixel of the image, its stride
+  // and its size.
+  using count_fn_t = void (*)(const uint8_t* buffer, std::ptrdiff_t stride, int width, int height, int white_level,
+                              int* out);
+
+  struct black_pixel_kernels
+  {
+    count_fn_t rows;    // Number of black pixels of each row
+    count_fn_t columns; // Number of black pixels of each column
+  };
+
+  // The kernels used by is_number_of_black_pixels_less_than(): the SIMD ones if the CPU supports them (and \p simd is
+  // true), the scalar ones otherwise
+  const black_pixel_kernels& black_pixel_counters(bool simd = true);
+} // namespace details
+
+
+/// Summed-area table of the black pixels (value < white_level) of an image. Once built, the row or column profile of
+/// any region is computed with O(height) or O(width) lookups.
+///
+/// Counts are stored modulo 2^16: a count over a region is exact as long as the region is less than 65536 pixels wide
+/// (row counts) or high (column counts).
+class BlackPixelTable
+{
+public:
+  BlackPixelTable() = default;
+  BlackPixelTable(const mln::image2d<uint8_t>& input, int white_level);
+
+  /// Number of black pixels of each column (Axis::Y) or each row (Axis::X) of the region
+  void count(mln::box2d roi, Axis axis, int* out) const;
+
+  mln::box2d domain() const { return m_domain; }
+
+private:
+  mln::box2d            m_domain;
+  std::vector<uint16_t> m_sums; // (width+1) x (height+1) table, the first row and column are 0
+};
+
+
+// Same as above but the counts are read from the table
+void is_number_of_black_pixels_less_than(const BlackPixelTable& table, mln::box2d roi, int threshold, Axis axis,
+                                         uint8_t* out);
+
+void is_number_of_black_pixels_less_than(const BlackPixelTable& table, mln::box2d roi, float percentile, Axis axis,
+                                         uint8_t* out);
+
+std::vector<uint8_t> is_number_of_black_pixels_less_than(const BlackPixelTable& table, mln::box2d roi,
+                                                         float percentile, Axis axis);
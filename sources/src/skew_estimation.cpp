@@ -7,6 +7,7 @@
 #include <mln/morpho/closing.hpp>
 #include <mln/morpho/opening.hpp>
 #include <mln/transforms/hough_lines.hpp>
+#include <tracing.hpp>
 
 namespace
 {
@@ -87,6 +88,7 @@ namespace scribo
 {
   float skew_estimation(const mln::image2d<uint8_t>& input, int xwidth, int xheight)
   {
+    scribo_entering("scribo::skew_estimation", input.width(), input.height());
     auto [g1, g2] = compute_gradients(input, xwidth, xheight);
 
 
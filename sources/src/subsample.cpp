@@ -1,6 +1,6 @@
 #include "subsample.hpp"
 
-#include <mln/core/trace.hpp>
+#include <tracing.hpp>
 #include <cmath>
 
 
@@ -62,7 +62,7 @@ namespace
 
 mln::image2d<uint8_t> resize(const mln::image2d<uint8_t>& input, float scale)
 {
-  mln_entering("scribo::resize");
+  scribo_entering("scribo::resize", input.width(), input.height());
   int width = input.width();
   int height = input.height();
 
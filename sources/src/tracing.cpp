@@ -0,0 +1,238 @@
+#include <tracing.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace
+{
+  struct event
+  {
+    const char*  name;
+    std::int64_t begin;
+    std::int64_t end;
+    int          width;
+    int          height;
+  };
+
+  constexpr int kChunkSize = 1024;
+
+  // The events of a thread are stored in a list of chunks that are never moved, so that they can be read while the
+  // thread appends new ones. `count` is published after the event is written.
+  struct chunk
+  {
+    event               events[kChunkSize];
+    std::atomic<chunk*> next = nullptr;
+  };
+
+  struct thread_buffer
+  {
+    int                      tid;
+    chunk                    head;
+    chunk*                   tail     = &head; // Owned by the thread (reset by the thread when it sees count == 0)
+    std::atomic<std::size_t> count    = 0;
+    bool                     finished = false; // The thread has exited (protected by the registry mutex)
+
+    ~thread_buffer() { free_chunks(); }
+
+    void free_chunks()
+    {
+      for (chunk* c = head.next.exchange(nullptr); c != nullptr;)
+        delete std::exchange(c, c->next.load());
+    }
+
+    // Drop the events, the buffer must not be owned by a thread
+    void clear()
+    {
+      count.store(0, std::memory_order_relaxed);
+      free_chunks();
+      tail     = &head;
+      finished = false;
+    }
+  };
+
+  // The buffers of the exited threads are kept until their events are cleared (they are exported later), then they
+  // are reused by the new threads
+  struct registry
+  {
+    std::mutex                                  mutex;
+    std::vector<std::unique_ptr<thread_buffer>> buffers; // Owned by a thread or holding the events of an exited one
+    std::vector<std::unique_ptr<thread_buffer>> unused;  // Empty buffers, to be reused
+    int                                         ntids = 0;
+    std::chrono::steady_clock::time_point       epoch = std::chrono::steady_clock::now();
+  };
+
+  registry& get_registry()
+  {
+    static registry r;
+    return r;
+  }
+
+  thread_buffer* acquire_buffer() noexcept
+  {
+    auto&            r = get_registry();
+    std::scoped_lock lock(r.mutex);
+    try
+    {
+      r.buffers.reserve(r.buffers.size() + 1);
+      if (!r.unused.empty())
+      {
+        r.buffers.push_back(std::move(r.unused.back()));
+        r.unused.pop_back();
+      }
+      else
+      {
+        r.buffers.push_back(std::make_unique<thread_buffer>());
+        r.buffers.back()->tid = ++r.ntids;
+      }
+      return r.buffers.back().get();
+    }
+    catch (const std::bad_alloc&)
+    {
+      return nullptr;
+    }
+  }
+
+  // Called when the thread exits: the buffer is reused at once if it is empty
+  void release_buffer(thread_buffer* b) noexcept
+  {
+    auto&            r = get_registry();
+    std::scoped_lock lock(r.mutex);
+    b->finished = true;
+    if (b->count.load(std::memory_order_relaxed) > 0)
+      return;
+
+    auto it = std::ranges::find(r.buffers, b, &std::unique_ptr<thread_buffer>::get);
+    try
+    {
+      r.unused.push_back(std::move(*it));
+      r.unused.back()->clear();
+    }
+    catch (const std::bad_alloc&)
+    {
+      it->reset(); // Deleted
+    }
+    r.buffers.erase(it);
+  }
+
+  // Hands the buffer of the thread back to the registry when the thread exits
+  struct buffer_owner
+  {
+    thread_buffer* buffer = nullptr;
+
+    ~buffer_owner()
+    {
+      if (buffer)
+        release_buffer(buffer);
+    }
+  };
+
+  thread_buffer* local_buffer() noexcept
+  {
+    thread_local buffer_owner owner;
+    if (!owner.buffer)
+      owner.buffer = acquire_buffer();
+    return owner.buffer;
+  }
+} // namespace
+
+
+namespace scribo::trace
+{
+  std::int64_t details::now() noexcept
+  {
+    auto d = std::chrono::steady_clock::now() - get_registry().epoch;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+  }
+
+  void details::record(const char* name, std::int64_t begin, std::int64_t end, int width, int height) noexcept
+  {
+    thread_buffer* b = local_buffer();
+    if (!b)
+      return;
+
+    // Acquire: the chunks freed by clear() are not used anymore
+    std::size_t n = b->count.load(std::memory_order_acquire);
+    if (n == 0)
+      b->tail = &b->head;
+    else if (n % kChunkSize == 0)
+    {
+      auto* c = new (std::nothrow) chunk;
+      if (!c)
+        return;
+      b->tail->next.store(c, std::memory_order_release);
+      b->tail = c;
+    }
+    b->tail->events[n % kChunkSize] = {name, begin, end, width, height};
+    b->count.store(n + 1, std::memory_order_release);
+  }
+
+  void enable(bool on) noexcept
+  {
+    if (on)
+      get_registry(); // Set the epoch
+    details::g_enabled.store(on, std::memory_order_relaxed);
+  }
+
+  void write_chrome_trace(std::ostream& os, std::int64_t since)
+  {
+    using json = nlohmann::json;
+
+    auto events = json::array();
+    {
+      auto&            r = get_registry();
+      std::scoped_lock lock(r.mutex);
+      for (const auto& b : r.buffers)
+      {
+        std::size_t  n = b->count.load(std::memory_order_acquire);
+        const chunk* c = &b->head;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          if (i > 0 && i % kChunkSize == 0)
+            c = c->next.load(std::memory_order_acquire);
+
+          const auto& e = c->events[i % kChunkSize];
+          if (e.begin < since)
+            continue;
+
+          json x = {{"name", e.name}, {"cat", "scribo"}, {"ph", "X"}, {"pid", 1}, {"tid", b->tid},
+                    {"ts", e.begin * 1e-3}, {"dur", (e.end - e.begin) * 1e-3}};
+          if (e.width > 0 || e.height > 0)
+            x["args"] = {{"width", e.width}, {"height", e.height}};
+          events.push_back(std::move(x));
+        }
+      }
+    }
+
+    os << json{{"traceEvents", std::move(events)}, {"displayTimeUnit", "ms"}};
+  }
+
+  void clear()
+  {
+    auto&            r = get_registry();
+    std::scoped_lock lock(r.mutex);
+    r.unused.reserve(r.unused.size() + r.buffers.size());
+    for (auto& b : r.buffers)
+    {
+      if (b->finished)
+      {
+        b->clear();
+        r.unused.push_back(std::move(b));
+      }
+      else
+      {
+        // The chunks are freed before the count is published, the thread resets its tail on its next record
+        b->free_chunks();
+        b->count.store(0, std::memory_order_release);
+      }
+    }
+    std::erase(r.buffers, nullptr);
+  }
+} // namespace scribo::trace
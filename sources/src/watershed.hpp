@@ -1,7 +1,42 @@
 #pragma once
 
+#include <mln/core/neighborhood/c4.hpp>
 #include <mln/morpho/watershed.hpp>
 
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace impl
+{
+  /// Watershed from markers: the pixels of \p markers > 0 are the seeds, the others must be 0. The basins are written
+  /// in \p markers (0 for the waterlines). Returns nlabel.
+  ///
+  /// 8-bit inputs with the 4-connectivity use a hierarchical queue (256 FIFO buckets over an index array, no
+  /// allocation during the flooding), the others the generic priority queue of pylene.
+  template <class I, class N, class O>
+  int watershed(I input, N nbh, O markers, int nlabel);
+
+  /// Same as mln::morpho::watershed (the markers are the regional minima of the input)
+  template <class Label_t>
+  mln::image2d<Label_t> watershed(const mln::image2d<uint8_t>& input, mln::c4_t nbh, int& nlabel);
+
+  /// Labelize the regional minima of an 8-bit image (4-connectivity) in raster order, the other pixels are set to 0.
+  /// Returns the number of minima. Throws if it does not fit in \p Label_t.
+  template <class Label_t>
+  int local_minima(const mln::image2d<uint8_t>& input, mln::image2d<Label_t>& output);
+
+  template <class I, class N, class O>
+  int watershed_pqueue(I input, N nbh, O markers, int nlabel);
+
+  template <class O>
+  int watershed_hqueue(const mln::image2d<uint8_t>& input, O markers, int nlabel);
+} // namespace impl
+
 
 
 /******************************************/
@@ -13,6 +48,15 @@ namespace impl
 
   template <class I, class N, class O>
   int watershed(I input, N nbh, O markers, int nlabel)
+  {
+    if constexpr (std::is_same_v<I, mln::image2d<uint8_t>> && std::is_same_v<N, mln::c4_t>)
+      return watershed_hqueue(input, markers, nlabel);
+    else
+      return watershed_pqueue(input, nbh, markers, nlabel);
+  }
+
+  template <class I, class N, class O>
+  int watershed_pqueue(I input, N nbh, O markers, int nlabel)
   {
     using Label_t = mln::image_value_t<O>;
 
@@ -122,4 +166,206 @@ namespace impl
 
     return nlabel;
   }
+
+  template <class O>
+  int watershed_hqueue(const mln::image2d<uint8_t>& input, O markers, int nlabel)
+  {
+    using Label_t = mln::image_value_t<O>;
+
+    constexpr int kUnlabeled = -2;
+    constexpr int kInqueue   = -1;
+    constexpr int kWaterline = 0;
+    constexpr int kNoLevel   = 256;
+
+    const int      w    = input.width();
+    const int      h    = input.height();
+    const uint8_t* ibuf = input.buffer();
+    Label_t*       obuf = markers.buffer();
+    const auto     is   = input.stride();
+    const auto     os   = markers.stride();
+
+    auto in  = [&](int x, int y) { return ibuf[y * is + x]; };
+    auto out = [&](int x, int y) -> Label_t& { return obuf[y * os + x]; };
+
+    // Every pixel is pushed at most once in the bucket of its level, so the buckets are slices of a single array
+    // sized from the histogram. Pixels are stored as linear indexes.
+    std::array<int, kNoLevel + 1> start = {};
+    for (int y = 0; y < h; ++y)
+      for (int x = 0; x < w; ++x)
+        start[in(x, y) + 1]++;
+    std::partial_sum(start.begin(), start.end(), start.begin());
+
+    std::vector<int>          queue(static_cast<std::size_t>(w) * h);
+    std::array<int, kNoLevel> head, tail;
+    std::copy_n(start.begin(), kNoLevel, head.begin());
+    std::copy_n(start.begin(), kNoLevel, tail.begin());
+    int level = kNoLevel; // Lowest non-empty bucket
+
+    auto push = [&](int x, int y) {
+      int v            = in(x, y);
+      queue[tail[v]++] = y * w + x;
+      level            = std::min(level, v);
+    };
+
+    // Neighbors in the same order as mln::c4 (pixels outside the domain are ignored)
+    constexpr int dx[] = {0, -1, 1, 0};
+    constexpr int dy[] = {-1, 0, 0, 1};
+    auto          for_each_neighbor = [&](int x, int y, auto f) {
+      for (int k = 0; k < 4; ++k)
+      {
+        int qx = x + dx[k], qy = y + dy[k];
+        if (0 <= qx && qx < w && 0 <= qy && qy < h)
+          if (!f(qx, qy))
+            break;
+      }
+    };
+
+    // 1. Queue the neighbors of the markers
+    for (int y = 0; y < h; ++y)
+      for (int x = 0; x < w; ++x)
+      {
+        if (out(x, y) != 0)
+          continue;
+
+        bool is_local_min_neighbor = false;
+        for_each_neighbor(x, y, [&](int qx, int qy) { return !(is_local_min_neighbor = (out(qx, qy) > 0)); });
+        if (is_local_min_neighbor)
+        {
+          out(x, y) = kInqueue;
+          push(x, y);
+        }
+        else
+        {
+          out(x, y) = kUnlabeled;
+        }
+      }
+
+    // 2. Flood from the markers
+    while (level < kNoLevel)
+    {
+      if (head[level] == tail[level])
+      {
+        level++;
+        continue;
+      }
+      int p = queue[head[level]++];
+      int x = p % w;
+      int y = p / w;
+
+      // Check if there is a single marked neighbor
+      Label_t common_label               = kWaterline;
+      bool    has_single_adjacent_marker = false;
+      for_each_neighbor(x, y, [&](int qx, int qy) {
+        int nlbl = out(qx, qy);
+        if (nlbl <= 0)
+          return true;
+        if (common_label == kWaterline)
+        {
+          common_label               = nlbl;
+          has_single_adjacent_marker = true;
+          return true;
+        }
+        if (nlbl != common_label)
+        {
+          has_single_adjacent_marker = false;
+          return false;
+        }
+        return true;
+      });
+
+      if (!has_single_adjacent_marker)
+      {
+        out(x, y) = kWaterline;
+      }
+      else
+      {
+        out(x, y) = common_label;
+        for_each_neighbor(x, y, [&](int qx, int qy) {
+          if (out(qx, qy) == kUnlabeled)
+          {
+            push(qx, qy);
+            out(qx, qy) = kInqueue;
+          }
+          return true;
+        });
+      }
+    }
+
+    // 3. Label all unlabeled pixels
+    for (int y = 0; y < h; ++y)
+      for (int x = 0; x < w; ++x)
+        if (out(x, y) < 0)
+          out(x, y) = kWaterline;
+
+    return nlabel;
+  }
+
+  template <class Label_t>
+  int local_minima(const mln::image2d<uint8_t>& input, mln::image2d<Label_t>& output)
+  {
+    static_assert(std::is_signed_v<Label_t> && sizeof(Label_t) <= sizeof(int), "The labels must be signed (<= int)");
+
+    const int      w    = input.width();
+    const int      h    = input.height();
+    const uint8_t* ibuf = input.buffer();
+    Label_t*       obuf = output.buffer();
+    const auto     is   = input.stride();
+    const auto     os   = output.stride();
+
+    constexpr int dx[] = {0, -1, 1, 0};
+    constexpr int dy[] = {-1, 0, 0, 1};
+
+    // Flat zones are visited in raster order of their first pixel. A flat zone is a minimum if none of its neighbors
+    // is lower.
+    std::vector<uint8_t> visited(static_cast<std::size_t>(w) * h, false);
+    std::vector<int>     zone;
+    int                  nlabel = 0;
+    for (int y0 = 0; y0 < h; ++y0)
+      for (int x0 = 0; x0 < w; ++x0)
+      {
+        if (visited[y0 * w + x0])
+          continue;
+
+        const uint8_t v          = ibuf[y0 * is + x0];
+        bool          is_minimum = true;
+        zone.assign(1, y0 * w + x0);
+        visited[y0 * w + x0] = true;
+        for (std::size_t i = 0; i < zone.size(); ++i)
+        {
+          int x = zone[i] % w;
+          int y = zone[i] / w;
+          for (int k = 0; k < 4; ++k)
+          {
+            int qx = x + dx[k], qy = y + dy[k];
+            if (qx < 0 || qx >= w || qy < 0 || qy >= h)
+              continue;
+            uint8_t vq = ibuf[qy * is + qx];
+            if (vq < v)
+              is_minimum = false;
+            else if (vq == v && !visited[qy * w + qx])
+            {
+              visited[qy * w + qx] = true;
+              zone.push_back(qy * w + qx);
+            }
+          }
+        }
+
+        if (is_minimum && nlabel == std::numeric_limits<Label_t>::max())
+          throw std::runtime_error("Label overflow in local_minima.");
+        Label_t lbl = is_minimum ? static_cast<Label_t>(++nlabel) : Label_t(0);
+        for (int p : zone)
+          obuf[(p / w) * os + (p % w)] = lbl;
+      }
+    return nlabel;
+  }
+
+  template <class Label_t>
+  mln::image2d<Label_t> watershed(const mln::image2d<uint8_t>& input, mln::c4_t nbh, int& nlabel)
+  {
+    mln::image2d<Label_t> output;
+    output.resize(input.domain());
+    nlabel = local_minima(input, output);
+    watershed(input, nbh, output, nlabel);
+    return output;
+  }
 } // namespace impl
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <scribo.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+
+// A page with two columns (regions 1 and 2) and their lines, grouped by column
+static std::vector<scribo::LayoutRegion> make_blocks()
+{
+  std::vector<scribo::LayoutRegion> blocks(3);
+  blocks[0].bbox = {0, 0, 2000, 3000};
+  blocks[0].type = DOMCategory::PAGE;
+  for (int k = 1; k <= 2; ++k)
+  {
+    blocks[k].bbox      = {100 + (k - 1) * 900, 200, 800, 2600};
+    blocks[k].type      = DOMCategory::COLUMN_LEVEL_2;
+    blocks[k].parent_id = 0;
+  }
+  return blocks;
+}
+
+static std::vector<scribo::LayoutRegion> make_lines(const std::vector<scribo::LayoutRegion>& blocks)
+{
+  std::mt19937                      gen(42);
+  std::vector<scribo::LayoutRegion> lines;
+  for (int k = 1; k <= 2; ++k)
+  {
+    Box col = blocks[k].bbox;
+    for (int y = col.y; y + 30 < col.y1(); y += 36)
+    {
+      bool first  = (gen() % 3 == 0);
+      int  indent = first ? 0 : 40;
+      int  end    = (gen() % 3 == 0) ? gen() % 300 : gen() % 10;
+
+      auto& l     = lines.emplace_back();
+      l.bbox      = {col.x + indent, y, col.width - indent - end, 24};
+      l.type      = DOMCategory::LINE;
+      l.parent_id = k;
+    }
+  }
+  return lines;
+}
+
+static void expect_same(const std::vector<scribo::LayoutRegion>& a, const std::vector<scribo::LayoutRegion>& b)
+{
+  ASSERT_EQ(a.size(), b.size());
+  for (std::size_t i = 0; i < a.size(); ++i)
+  {
+    EXPECT_EQ(a[i].type, b[i].type) << "region " << i;
+    EXPECT_EQ(a[i].parent_id, b[i].parent_id) << "region " << i;
+    EXPECT_EQ(a[i].bbox.x, b[i].bbox.x) << "region " << i;
+    EXPECT_EQ(a[i].bbox.y, b[i].bbox.y) << "region " << i;
+    EXPECT_EQ(a[i].bbox.width, b[i].bbox.width) << "region " << i;
+    EXPECT_EQ(a[i].bbox.height, b[i].bbox.height) << "region " << i;
+  }
+}
+
+
+// The batched version gives the same entries and line parents as the per-column version
+TEST(UTEntryExtraction, BatchSameAsPerColumn)
+{
+  auto blocks = make_blocks();
+  auto lines  = make_lines(blocks);
+
+  auto out1   = blocks;
+  auto lines1 = lines;
+  scribo::EntryExtraction(lines1, out1);
+
+  auto out2   = blocks;
+  auto lines2 = lines;
+  int  half   = static_cast<int>(std::ranges::count(lines, 1, &scribo::LayoutRegion::parent_id));
+  scribo::EntryExtraction(out2[1].bbox, std::span(lines2).subspan(0, half), out2);
+  scribo::EntryExtraction(out2[2].bbox, std::span(lines2).subspan(half), out2);
+
+  ASSERT_GT(out1.size(), blocks.size() + 2);
+  expect_same(out1, out2);
+  expect_same(lines1, lines2);
+}
+
+// Same when the lines live in `out` (the entries are appended after them and `out` is reallocated)
+TEST(UTEntryExtraction, BatchSameAsPerColumnAliasing)
+{
+  auto blocks = make_blocks();
+  auto lines  = make_lines(blocks);
+  int  start  = static_cast<int>(blocks.size());
+  int  half   = static_cast<int>(std::ranges::count(lines, 1, &scribo::LayoutRegion::parent_id));
+
+  auto out1 = blocks;
+  out1.insert(out1.end(), lines.begin(), lines.end());
+  out1.shrink_to_fit();
+  scribo::EntryExtraction(std::span(out1).subspan(start), out1);
+
+  auto out2 = blocks;
+  out2.insert(out2.end(), lines.begin(), lines.end());
+  out2.shrink_to_fit();
+  scribo::EntryExtraction(out2[1].bbox, std::span(out2).subspan(start, half), out2);
+  scribo::EntryExtraction(out2[2].bbox, std::span(out2).subspan(start + half, lines.size() - half), out2);
+
+  // Same result as with the lines outside `out` (up to the offset of the entry indexes)
+  auto out3   = blocks;
+  auto lines3 = lines;
+  scribo::EntryExtraction(lines3, out3);
+  int nlines = static_cast<int>(lines.size());
+  for (auto& l : lines3)
+    l.parent_id += nlines;
+  for (std::size_t i = start; i < out3.size(); ++i)
+    lines3.push_back(out3[i]);
+  out3.resize(start);
+  out3.insert(out3.end(), lines3.begin(), lines3.end());
+
+  expect_same(out1, out2);
+  expect_same(out1, out3);
+}
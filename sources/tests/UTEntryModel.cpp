@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <EntryModel.hpp>
+
+#include <cmath>
+#include <random>
+#include <span>
+#include <sstream>
+
+
+// Reference evaluation by walking the tree
+static float walk(std::span<const scribo::tree_node> nodes, const float* x)
+{
+  int i = 0;
+  while (nodes[i].left >= 0)
+    i = (x[nodes[i].feature] <= nodes[i].threshold) ? nodes[i].left : nodes[i].right;
+  return nodes[i].value;
+}
+
+static std::vector<std::array<float, 3>> random_features(int n)
+{
+  std::mt19937                          gen(42);
+  std::uniform_int_distribution<int>    space(0, 40);
+  std::uniform_real_distribution<float> ratio(0.f, 0.1f);
+
+  std::vector<std::array<float, 3>> x(n);
+  for (auto& v : x)
+    v = {(float)space(gen), (float)space(gen), ratio(gen)};
+
+  // Values on the thresholds
+  x[0] = {5.f, 7.f, 0.050192078575491905f};
+  x[1] = {15.f, 17.f, 0.023809523321688175f};
+  x[2] = {1.f, 5.f, 0.0012019231216982007f};
+  return x;
+}
+
+TEST(UTEntryModel, StaticTree)
+{
+  constexpr auto t0 = scribo::make_static_tree<4>(scribo::kDefaultEntryTree0);
+  constexpr auto t1 = scribo::make_static_tree<4>(scribo::kDefaultEntryTree1);
+
+  for (const auto& x : random_features(10000))
+  {
+    ASSERT_EQ(t0(x.data()), walk(scribo::kDefaultEntryTree0, x.data()));
+    ASSERT_EQ(t1(x.data()), walk(scribo::kDefaultEntryTree1, x.data()));
+  }
+}
+
+TEST(UTEntryModel, RuntimeModelMatchesStaticModel)
+{
+  scribo::EntryModel          model;
+  scribo::default_entry_model ref;
+
+  for (const auto& x : random_features(10000))
+  {
+    float p[2], q[2];
+    model.predict(x.data(), p);
+    ref.predict(x.data(), q);
+    ASSERT_EQ(p[0], q[0]);
+    ASSERT_EQ(p[1], q[1]);
+  }
+}
+
+TEST(UTEntryModel, LoadEnsemble)
+{
+  // Two stumps + sigmoid for the first classifier, a constant for the second one
+  std::istringstream is(R"({ "classifiers": [
+    { "base_score": -1.0, "link": "sigmoid", "trees": [
+      { "children_left": [1, -1, -1], "children_right": [2, -1, -1], "feature": [0, -2, -2],
+        "threshold": [10.0, -2.0, -2.0], "value": [0.0, 0.5, 2.0] },
+      { "children_left": [1, -1, -1], "children_right": [2, -1, -1], "feature": [1, -2, -2],
+        "threshold": [3.0, -2.0, -2.0], "value": [0.0, 0.5, -1.0] } ] },
+    { "trees": [ { "children_left": [-1], "children_right": [-1], "feature": [-2],
+                   "threshold": [-2.0], "value": [0.25] } ] }
+  ] })");
+
+  auto model = scribo::EntryModel::load(is);
+
+  float x[3] = {12.f, 1.f, 0.f};
+  float p[2];
+  model.predict(x, p);
+  ASSERT_FLOAT_EQ(p[0], 1 / (1 + std::exp(-(-1.f + 2.f + 0.5f))));
+  ASSERT_FLOAT_EQ(p[1], 0.25f);
+}
+
+TEST(UTEntryModel, LoadInvalid)
+{
+  std::istringstream cycle(R"({ "classifiers": [
+    { "trees": [ { "children_left": [1, 0], "children_right": [1, 0], "feature": [0, 0],
+                   "threshold": [0, 0], "value": [0, 0] } ] },
+    { "trees": [] } ] })");
+  ASSERT_THROW(scribo::EntryModel::load(cycle), std::runtime_error);
+
+  std::istringstream garbage("{ \"classifiers\": ");
+  ASSERT_THROW(scribo::EntryModel::load(garbage), std::runtime_error);
+}
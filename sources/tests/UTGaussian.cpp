@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "../src/gaussian_directional_2d.hpp"
+
+#include <mln/core/algorithm/clone.hpp>
+#include <mln/core/image/ndimage.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+
+static mln::image2d<uint8_t> make_input(int width, int height, unsigned seed)
+{
+  std::mt19937          gen(seed);
+  mln::image2d<uint8_t> input(width, height);
+  for (int y = 0; y < height; ++y)
+    for (int x = 0; x < width; ++x)
+      input({x, y}) = static_cast<uint8_t>((gen() % 4 == 0) ? gen() % 64 : 255 - gen() % 32);
+  return input;
+}
+
+// Reference: the columns, then the rows, are filtered one by one through a single padded buffer whose border is
+// initialized once per pass (the filtered border of a column is the padding of the next one)
+static void gaussian2d_ref(mln::image2d<uint8_t>& f, float h_sigma, float v_sigma, uint8_t border_value)
+{
+  int  b      = 5 * static_cast<int>(std::max(h_sigma, v_sigma) + 0.5f);
+  auto dom    = f.domain();
+  auto filter = [&](int n, float sigma, auto get, auto set) {
+    std::vector<float> signal(n + 2 * b, border_value), tmp(2 * (n + 2 * b));
+    return [=](int i) mutable {
+      for (int k = 0; k < n; ++k)
+        signal[b + k] = get(i, k);
+      details::gaussian1d(signal.data(), n + 2 * b, sigma, tmp.data());
+      for (int k = 0; k < n; ++k)
+        set(i, k, static_cast<uint8_t>(std::clamp(int(signal[b + k] + 0.5f), 0, 255)));
+    };
+  };
+
+  if (v_sigma != 0.f)
+  {
+    auto column = filter(
+        f.height(), v_sigma, [&](int x, int y) { return f({dom.x() + x, dom.y() + y}); },
+        [&](int x, int y, uint8_t v) { f({dom.x() + x, dom.y() + y}) = v; });
+    for (int x = 0; x < f.width(); ++x)
+      column(x);
+  }
+  if (h_sigma != 0.f)
+  {
+    auto row = filter(
+        f.width(), h_sigma, [&](int y, int x) { return f({dom.x() + x, dom.y() + y}); },
+        [&](int y, int x, uint8_t v) { f({dom.x() + x, dom.y() + y}) = v; });
+    for (int y = 0; y < f.height(); ++y)
+      row(y);
+  }
+}
+
+static void expect_same(const mln::image2d<uint8_t>& a, const mln::image2d<uint8_t>& b)
+{
+  ASSERT_EQ(a.width(), b.width());
+  ASSERT_EQ(a.height(), b.height());
+  int ndiff = 0;
+  for (int y = 0; y < a.height(); ++y)
+    for (int x = 0; x < a.width(); ++x)
+      ndiff += (a({a.domain().x() + x, a.domain().y() + y}) != b({b.domain().x() + x, b.domain().y() + y}));
+  EXPECT_EQ(ndiff, 0);
+}
+
+
+// The output is the same, bit for bit, as filtering the columns then the rows one by one with chained borders
+TEST(UTGaussian, SameAsColumnByColumn)
+{
+  for (auto [width, height, h_sigma, v_sigma] : {std::tuple{203, 157, 10.f, 3.f}, std::tuple{16, 300, 12.f, 4.f},
+                                                 std::tuple{301, 33, 0.f, 3.f}, std::tuple{97, 64, 10.f, 0.f}})
+  {
+    auto input = make_input(width, height, width);
+    auto ref   = mln::clone(input);
+    auto out   = mln::clone(input);
+    gaussian2d_ref(ref, h_sigma, v_sigma, 255);
+    gaussian2d(out, h_sigma, v_sigma, 255);
+    expect_same(out, ref);
+  }
+}
+
+// Same on a sub-image (the stride is larger than the width) with a reused scratch buffer
+TEST(UTGaussian, SameAsColumnByColumnView)
+{
+  auto               input = make_input(400, 300, 42);
+  std::vector<float> scratch;
+  for (auto roi : {mln::box2d{13, 7, 250, 200}, mln::box2d{100, 50, 37, 211}})
+  {
+    auto ref  = mln::clone(input.clip(roi));
+    auto out  = mln::clone(input);
+    auto view = out.clip(roi);
+    gaussian2d_ref(ref, 10.f, 3.f, 255);
+    gaussian2d(view, 10.f, 3.f, 255, scratch);
+    expect_same(view, ref);
+  }
+}
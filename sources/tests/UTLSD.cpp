@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+
+extern "C"
+{
+#include <lsd.h>
+}
+
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+
+namespace
+{
+  constexpr int kWidth  = 1024;
+  constexpr int kHeight = 1400;
+  constexpr int kStride = 1040; // Padded rows
+
+  struct lsd_segment
+  {
+    double x1, y1, x2, y2;
+  };
+
+  // Noisy white page with dark rules (vertical, horizontal and slanted) and blocks of "words"
+  std::vector<unsigned char> make_page()
+  {
+    std::vector<unsigned char> page(kStride * kHeight, 0);
+    std::mt19937               gen(42);
+    std::uniform_int_distribution<int> noise(-10, 10);
+
+    auto at = [&](int x, int y) -> unsigned char& { return page[x + y * kStride]; };
+    for (int y = 0; y < kHeight; ++y)
+      for (int x = 0; x < kWidth; ++x)
+        at(x, y) = 230 + noise(gen);
+
+    auto fill = [&](int x0, int y0, int w, int h) {
+      for (int y = y0; y < y0 + h; ++y)
+        for (int x = x0; x < x0 + w; ++x)
+          at(x, y) = 30 + noise(gen);
+    };
+
+    fill(100, 100, 824, 3);  // Horizontal rule
+    fill(340, 150, 3, 1150); // Vertical rules
+    fill(680, 150, 4, 1150);
+    for (int y = 200; y < 1200; ++y) // Slanted rule
+      fill(900 + (y - 200) / 20, y, 3, 1);
+
+    for (int y = 160; y < 1280; y += 32) // Words
+      for (int x = 120; x < 320; x += 60)
+        fill(x, y, 48, 14);
+    return page;
+  }
+
+  std::vector<lsd_segment> to_segments(double* out, int n)
+  {
+    std::vector<lsd_segment> s(n);
+    for (int i = 0; i < n; ++i)
+      s[i] = {out[7 * i + 0], out[7 * i + 1], out[7 * i + 2], out[7 * i + 3]};
+    std::free(out);
+    return s;
+  }
+
+  // Same parameters as detect_separators_LSD
+  constexpr double kScale      = 0.5;
+  constexpr double kSigmaScale = 0.6;
+  constexpr double kQuant      = 2.0;
+  constexpr double kAngTh      = 22.5;
+  constexpr double kLogEps     = 2.0;
+  constexpr double kDensityTh  = 0.7;
+  constexpr int    kNBins      = 1024;
+
+  std::vector<lsd_segment> run_double(const std::vector<unsigned char>& page)
+  {
+    std::vector<double> f(kWidth * kHeight);
+    for (int y = 0; y < kHeight; ++y)
+      for (int x = 0; x < kWidth; ++x)
+        f[x + y * kWidth] = page[x + y * kStride];
+
+    int  n   = 0;
+    auto out = LineSegmentDetection(&n, f.data(), kWidth, kHeight, kScale, kSigmaScale, kQuant, kAngTh, kLogEps,
+                                    kDensityTh, kNBins, nullptr, nullptr, nullptr);
+    return to_segments(out, n);
+  }
+
+  std::vector<lsd_segment> run_u8(const std::vector<unsigned char>& page)
+  {
+    int  n   = 0;
+    auto out = LineSegmentDetection_u8(&n, page.data(), kWidth, kHeight, kStride, kScale, kSigmaScale, kQuant, kAngTh,
+                                       kLogEps, kDensityTh, kNBins);
+    return to_segments(out, n);
+  }
+
+  // Distance between the end-points (in any order)
+  double distance(const lsd_segment& a, const lsd_segment& b)
+  {
+    auto d = [](double x1, double y1, double x2, double y2) { return std::hypot(x1 - x2, y1 - y2); };
+    double direct  = std::max(d(a.x1, a.y1, b.x1, b.y1), d(a.x2, a.y2, b.x2, b.y2));
+    double reverse = std::max(d(a.x1, a.y1, b.x2, b.y2), d(a.x2, a.y2, b.x1, b.y1));
+    return std::min(direct, reverse);
+  }
+
+  // Largest distance from the end-points of `b` to the line of `a`
+  double line_distance(const lsd_segment& a, const lsd_segment& b)
+  {
+    double dx = a.x2 - a.x1, dy = a.y2 - a.y1;
+    double n  = std::hypot(dx, dy);
+    auto   d  = [&](double x, double y) { return std::abs((x - a.x1) * dy - (y - a.y1) * dx) / n; };
+    return std::max(d(b.x1, b.y1), d(b.x2, b.y2));
+  }
+
+  double length(const lsd_segment& s) { return std::hypot(s.x2 - s.x1, s.y2 - s.y1); }
+} // namespace
+
+
+// The 8-bit path (box filter + residual gaussian) finds the same long segments as the double path (gaussian
+// sampler): on the same line within one pixel, with end-points within a few pixels.
+TEST(UTLSD, U8MatchesDouble)
+{
+  auto page = make_page();
+  auto ref  = run_double(page);
+  auto u8   = run_u8(page);
+
+  int nlong = 0;
+  for (const auto& r : ref)
+  {
+    if (length(r) < 100)
+      continue;
+    nlong++;
+
+    bool found = false;
+    for (const auto& s : u8)
+      found |= (distance(r, s) <= 3 && line_distance(r, s) <= 1);
+    EXPECT_TRUE(found) << "Segment (" << r.x1 << "," << r.y1 << ")-(" << r.x2 << "," << r.y2 << ") not found";
+  }
+  ASSERT_GE(nlong, 4);
+}
+
+// The box filter averages the input pixels [k.x, k.x+k), so the output pixel x is centered at k.x + (k-1)/2 in the
+// input. With this offset, the two edges of a rule are symmetric around its center (without it, they are shifted by
+// -0.5 pixel).
+TEST(UTLSD, U8Offset)
+{
+  auto page = make_page();
+  auto u8   = run_u8(page);
+
+  // Vertical rule [680, 683] (center 681.5) and horizontal rule [100, 102] (center 101)
+  double sx = 0, sy = 0;
+  int    nx = 0, ny = 0;
+  for (const auto& s : u8)
+  {
+    if (length(s) < 500)
+      continue;
+    if (std::abs(s.x1 - s.x2) < 1 && std::abs(s.x1 - 681.5) < 5)
+    {
+      sx += s.x1 + s.x2;
+      nx += 2;
+    }
+    if (std::abs(s.y1 - s.y2) < 1 && std::abs(s.y1 - 101) < 5)
+    {
+      sy += s.y1 + s.y2;
+      ny += 2;
+    }
+  }
+  ASSERT_EQ(nx, 4); // Both edges
+  ASSERT_EQ(ny, 4);
+  EXPECT_NEAR(sx / nx, 681.5, 0.2);
+  EXPECT_NEAR(sy / ny, 101.0, 0.2);
+}
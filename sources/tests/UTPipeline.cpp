@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include <pipeline.hpp>
+
+#include <mln/core/image/ndimage.hpp>
+
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+
+namespace
+{
+  void fill_rect(mln::image2d<uint8_t>& ima, int x0, int y0, int w, int h, uint8_t v)
+  {
+    for (int y = y0; y < y0 + h; ++y)
+      for (int x = x0; x < x0 + w; ++x)
+        ima({x, y}) = v;
+  }
+
+  // White page with `ncols` columns of text lines
+  mln::image2d<uint8_t> make_page(int height, int ncols, unsigned seed)
+  {
+    constexpr int kWidth  = 2048;
+    constexpr int kMargin = 100;
+    constexpr int kGutter = 60;
+
+    std::mt19937          gen(seed);
+    mln::image2d<uint8_t> input(kWidth, height);
+    fill_rect(input, 0, 0, kWidth, height, 230);
+
+    for (int c = 0; c < ncols; ++c)
+    {
+      int colwidth = (kWidth - 2 * kMargin - (ncols - 1) * kGutter) / ncols;
+      int x0       = kMargin + c * (colwidth + kGutter);
+      for (int y = kMargin; y + 36 < height - kMargin; y += 36)
+        for (int x = x0 + (gen() % 2) * 30; x + 12 < x0 + colwidth - int(gen() % 100); x += 12)
+          if (gen() % 6 != 0) // Word spacing
+            fill_rect(input, x, y, 10, 14, 40);
+    }
+    return input;
+  }
+
+  // Pages of decreasing sizes, so that the last pages are likely to be done first
+  std::vector<mln::image2d<uint8_t>> make_pages(int n)
+  {
+    std::vector<mln::image2d<uint8_t>> pages;
+    for (int i = 0; i < n; ++i)
+      pages.push_back(make_page(3000 - 300 * i, 1 + i % 3, i));
+    return pages;
+  }
+} // namespace
+
+
+// The results are handed over in the order of the pages and are the same as the ones of process_page()
+TEST(UTPipeline, ProcessPagesInOrder)
+{
+  auto pages = make_pages(6);
+
+  std::vector<scribo::page_result> ref;
+  for (const auto& p : pages)
+    ref.push_back(scribo::process_page(p));
+
+  for (int n_threads : {1, 3, 0})
+  {
+    int next = 0;
+    scribo::process_pages(pages, {}, n_threads, [&](int i, scribo::page_result&& r) {
+      ASSERT_EQ(i, next++) << "n_threads=" << n_threads;
+      EXPECT_EQ(r.cleaning.xheight, ref[i].cleaning.xheight) << "page " << i;
+      ASSERT_EQ(r.regions.size(), ref[i].regions.size()) << "page " << i;
+      for (std::size_t k = 0; k < r.regions.size(); ++k)
+      {
+        EXPECT_EQ(r.regions[k].type, ref[i].regions[k].type) << "page " << i << " region " << k;
+        EXPECT_EQ(r.regions[k].parent_id, ref[i].regions[k].parent_id) << "page " << i << " region " << k;
+        EXPECT_EQ(r.regions[k].bbox.x, ref[i].regions[k].bbox.x);
+        EXPECT_EQ(r.regions[k].bbox.y, ref[i].regions[k].bbox.y);
+        EXPECT_EQ(r.regions[k].bbox.width, ref[i].regions[k].bbox.width);
+        EXPECT_EQ(r.regions[k].bbox.height, ref[i].regions[k].bbox.height);
+      }
+    });
+    EXPECT_EQ(next, (int)pages.size()) << "n_threads=" << n_threads;
+  }
+}
+
+// An error stops the pipeline: the pages after the failing one are not handed over, the pages in flight are
+// cancelled and the exception is rethrown to the caller
+TEST(UTPipeline, ProcessPagesError)
+{
+  auto pages = make_pages(6);
+
+  for (int n_threads : {1, 3, 0})
+  {
+    std::vector<int> delivered;
+    auto             on_result = [&](int i, scribo::page_result&&) {
+      delivered.push_back(i);
+      if (i == 2)
+        throw std::logic_error("stop");
+    };
+    EXPECT_THROW(scribo::process_pages(pages, {}, n_threads, on_result), std::logic_error) << "n_threads=" << n_threads;
+    EXPECT_EQ(delivered, (std::vector<int>{0, 1, 2})) << "n_threads=" << n_threads;
+  }
+}
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include "../src/SegmentIndex.hpp"
+
+#include <algorithm>
+#include <vector>
+
+
+static Segment make_segment(int x0, int y0, int x1, int y1)
+{
+  Segment s = {};
+  s.start   = {x0, y0};
+  s.end     = {x1, y1};
+  return s;
+}
+
+TEST(UTSegmentIndex, Empty) {
+  SegmentIndex index;
+  ASSERT_EQ(index.count_in(Box{0, 0, 100, 100}), 0);
+}
+
+TEST(UTSegmentIndex, Contains) {
+  std::vector<Segment> segments = {
+      make_segment(10, 10, 90, 10),  // Horizontal
+      make_segment(50, 0, 50, 99),   // Vertical
+      make_segment(90, 20, 10, 80),  // Descending from right to left
+      make_segment(200, 200, 300, 200),
+  };
+  SegmentIndex index(segments);
+
+  ASSERT_EQ(index.count_in(Box{0, 0, 100, 100}), 3);
+  ASSERT_EQ(index.count_in(Box{0, 0, 100, 99}), 2);  // Box is half-open
+  ASSERT_EQ(index.count_in(Box{11, 0, 100, 100}), 1); // Only the vertical one
+  ASSERT_EQ(index.count_in(Box{0, 0, 1000, 1000}), 4);
+  ASSERT_EQ(index.count_in(Box{0, 0, 0, 0}), 0);
+}
+
+TEST(UTSegmentIndex, SameAsLinearScan) {
+  std::vector<Segment> segments;
+  for (int i = 0; i < 500; ++i)
+  {
+    int x = (i * 37) % 1000, y = (i * 91) % 1000;
+    segments.push_back(make_segment(x, y, x + (i % 7) * 20, y + (i % 5) * 30));
+  }
+  SegmentIndex index(segments);
+
+  for (Box region : {Box{0, 0, 500, 500}, Box{100, 250, 300, 400}, Box{600, 10, 450, 990}})
+  {
+    std::vector<const Segment*> expected, found;
+    for (const auto& s : segments)
+      if (region.has(s))
+        expected.push_back(&s);
+    index.for_each_in(region, [&](const Segment& s) { found.push_back(&s); });
+    std::sort(found.begin(), found.end());
+    ASSERT_EQ(found, expected);
+  }
+}
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include "../src/detect_separators.hpp"
+
+#include <mln/core/image/ndimage.hpp>
+
+#include <cmath>
+#include <random>
+
+
+// Noisy white page with a long vertical rule (crossing all the bands), a shorter one and a horizontal rule
+static mln::image2d<uint8_t> make_page(int width, int height)
+{
+  std::mt19937                       gen(42);
+  std::uniform_int_distribution<int> noise(-10, 10);
+  mln::image2d<uint8_t>              input(width, height);
+  for (int y = 0; y < height; ++y)
+    for (int x = 0; x < width; ++x)
+      input({x, y}) = static_cast<uint8_t>(230 + noise(gen));
+
+  auto fill = [&](int x0, int y0, int w, int h) {
+    for (int y = y0; y < y0 + h; ++y)
+      for (int x = x0; x < x0 + w; ++x)
+        input({x, y}) = static_cast<uint8_t>(30 + noise(gen));
+  };
+
+  fill(800, 200, 4, 2600);  // Vertical rule through the 6 bands
+  fill(1400, 900, 3, 1200); // Vertical rule through 3 bands
+  fill(200, 1500, 500, 3);  // Horizontal rule
+  return input;
+}
+
+// The vertical segments whose x is in [x0, x1]
+static std::vector<Segment> vertical_at(const std::vector<Segment>& segments, int x0, int x1)
+{
+  std::vector<Segment> res;
+  for (const auto& s : segments)
+    if (std::abs(s.start.x - s.end.x) <= 2 && s.start.x >= x0 && s.start.x <= x1)
+      res.push_back(s);
+  return res;
+}
+
+
+// A rule cut by the band boundaries comes back as a single segment (per edge), as with the whole-page detection
+TEST(UTSeparators, TiledMergesAcrossBands)
+{
+  auto input = make_page(1800, 3000);
+  auto ref   = detect_separators_LSD(input);
+  auto tiled = detect_separators_LSD_tiled(input, 6, 50);
+
+  for (auto [x0, x1, length] : {std::tuple{795, 810, 2600}, std::tuple{1395, 1410, 1200}})
+  {
+    auto r = vertical_at(ref, x0, x1);
+    auto t = vertical_at(tiled, x0, x1);
+    ASSERT_FALSE(r.empty());
+    ASSERT_EQ(t.size(), r.size());
+    for (const auto& s : t)
+    {
+      EXPECT_GE(s.length, length - 10);
+      EXPECT_LE(s.length, length + 10);
+    }
+  }
+}
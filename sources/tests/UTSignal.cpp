@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include "../src/signal.hpp"
+
+#include <mln/core/image/ndimage.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+
+static mln::image2d<uint8_t> make_input(int width, int height, unsigned seed)
+{
+  std::mt19937          gen(seed);
+  mln::image2d<uint8_t> input(width, height);
+  for (int y = 0; y < height; ++y)
+    for (int x = 0; x < width; ++x)
+      input({x, y}) = static_cast<uint8_t>(gen());
+  return input;
+}
+
+// Reference counts (naive loops over the pixels)
+static std::vector<int> count_black(const mln::image2d<uint8_t>& input, int white_level, Axis axis)
+{
+  std::vector<int> count((axis == Axis::Y) ? input.width() : input.height(), 0);
+  auto             dom = input.domain();
+  for (int y = 0; y < input.height(); ++y)
+    for (int x = 0; x < input.width(); ++x)
+      if (input({dom.x() + x, dom.y() + y}) < white_level)
+        count[(axis == Axis::Y) ? x : y]++;
+  return count;
+}
+
+static void check_kernels(const mln::image2d<uint8_t>& input, bool simd)
+{
+  const auto& k = details::black_pixel_counters(simd);
+  for (int white_level : {1, 100, 200, 255})
+  {
+    std::vector<int> rows(input.height()), columns(input.width());
+    k.rows(input.buffer(), input.stride(), input.width(), input.height(), white_level, rows.data());
+    k.columns(input.buffer(), input.stride(), input.width(), input.height(), white_level, columns.data());
+    EXPECT_EQ(rows, count_black(input, white_level, Axis::X))
+        << "width=" << input.width() << " white_level=" << white_level << " simd=" << simd;
+    EXPECT_EQ(columns, count_black(input, white_level, Axis::Y))
+        << "width=" << input.width() << " white_level=" << white_level << " simd=" << simd;
+  }
+}
+
+
+// Widths that are not a multiple of the vector size (the tails are processed by the scalar loop)
+TEST(UTSignal, BlackPixelCountersOddWidths)
+{
+  for (int width : {1, 7, 31, 32, 33, 63, 65, 257, 1001})
+  {
+    auto input = make_input(width, 37, width);
+    check_kernels(input, false);
+    check_kernels(input, true);
+  }
+}
+
+// Sub-images: the rows are not aligned and the stride is larger than the width
+TEST(UTSignal, BlackPixelCountersStridedView)
+{
+  auto input = make_input(1037, 211, 42);
+  for (auto roi : {mln::box2d{3, 5, 97, 50}, mln::box2d{1, 0, 1033, 211}, mln::box2d{511, 100, 65, 17}})
+  {
+    auto view = input.clip(roi);
+    check_kernels(view, false);
+    check_kernels(view, true);
+  }
+}
+
+// More than 255 vectors per row (byte counters) and more than 65535 rows (16-bit counters)
+TEST(UTSignal, BlackPixelCountersLarge)
+{
+  check_kernels(make_input(255 * 32 + 45, 3, 1), true);
+  check_kernels(make_input(45, 70000, 2), true);
+}
+
+static void check_table(const mln::image2d<uint8_t>& input, int white_level, std::mt19937& gen, int nrois)
+{
+  BlackPixelTable table(input, white_level);
+  auto            dom = input.domain();
+
+  // The whole domain, then random regions
+  for (int i = 0; i <= nrois; ++i)
+  {
+    mln::box2d roi = dom;
+    if (i > 0)
+    {
+      int x0 = gen() % dom.width(), x1 = gen() % dom.width();
+      int y0 = gen() % dom.height(), y1 = gen() % dom.height();
+      roi    = mln::box2d{dom.x() + std::min(x0, x1), dom.y() + std::min(y0, y1), std::abs(x1 - x0) + 1,
+                       std::abs(y1 - y0) + 1};
+    }
+
+    for (Axis axis : {Axis::X, Axis::Y})
+    {
+      auto             ref = count_black(input.clip(roi), white_level, axis);
+      std::vector<int> count(ref.size());
+      table.count(roi, axis, count.data());
+      EXPECT_EQ(count, ref) << "roi " << i << " axis=" << int(axis);
+
+      // The thresholded profile
+      int  n   = (axis == Axis::Y) ? roi.height() : roi.width();
+      auto out = is_number_of_black_pixels_less_than(table, roi, 0.3f, axis);
+      ASSERT_EQ(out.size(), ref.size());
+      for (std::size_t k = 0; k < ref.size(); ++k)
+        EXPECT_EQ(out[k], ref[k] < int(0.3f * n)) << "roi " << i << " axis=" << int(axis) << " k=" << k;
+    }
+  }
+}
+
+
+// The table counts are the same as the naive ones, for any region and both axes
+TEST(UTSignal, BlackPixelTableRandomRegions)
+{
+  std::mt19937 gen(42);
+  for (auto [width, height] : {std::pair{1, 1}, std::pair{37, 211}, std::pair{257, 64}})
+  {
+    auto input = make_input(width, height, width);
+    for (int white_level : {1, 128, 255})
+      check_table(input, white_level, gen, 50);
+  }
+
+  // On a sub-image (the domain does not start at 0 and the stride is larger than the width)
+  auto input = make_input(300, 200, 7);
+  check_table(input.clip(mln::box2d{13, 21, 150, 120}), 128, gen, 50);
+}
+
+// More than 65535 black pixels: the 16-bit sums wrap around but the counts are still exact
+TEST(UTSignal, BlackPixelTableWrapAround)
+{
+  std::mt19937 gen(1);
+  auto         input = make_input(700, 500, 3);
+  check_table(input, 250, gen, 20); // ~98% of black pixels, ~340000 in total
+}
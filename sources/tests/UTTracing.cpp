@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include <tracing.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+
+static nlohmann::json export_trace(std::int64_t since = 0)
+{
+  std::stringstream ss;
+  scribo::trace::write_chrome_trace(ss, since);
+  return nlohmann::json::parse(ss);
+}
+
+TEST(UTTracing, Disabled)
+{
+  scribo::trace::clear();
+  scribo::trace::enable(false);
+  {
+    scribo_entering("disabled");
+  }
+  ASSERT_TRUE(export_trace()["traceEvents"].empty());
+}
+
+TEST(UTTracing, Threads)
+{
+  constexpr int kThreads = 4;
+  constexpr int kSpans   = 3000; // Several chunks per thread
+
+  scribo::trace::clear();
+  scribo::trace::enable();
+
+  std::vector<std::thread> threads;
+  for (int k = 0; k < kThreads; ++k)
+    threads.emplace_back([] {
+      for (int i = 0; i < kSpans; ++i)
+      {
+        scribo_entering("span", 20, 10);
+      }
+    });
+  for (auto& t : threads)
+    t.join();
+
+  {
+    scribo_entering("main");
+  }
+  scribo::trace::enable(false);
+
+  auto events = export_trace()["traceEvents"];
+  ASSERT_EQ(events.size(), kThreads * kSpans + 1);
+
+  std::set<int> tids;
+  for (const auto& e : events)
+  {
+    ASSERT_EQ(e["ph"], "X");
+    ASSERT_GE(e["dur"].get<double>(), 0);
+    if (e["name"] == "span")
+    {
+      ASSERT_EQ(e["args"]["width"], 20);
+      ASSERT_EQ(e["args"]["height"], 10);
+      tids.insert(e["tid"].get<int>());
+    }
+  }
+  ASSERT_EQ(tids.size(), kThreads);
+}
+
+TEST(UTTracing, Since)
+{
+  scribo::trace::clear();
+  scribo::trace::enable();
+  {
+    scribo_entering("before");
+  }
+  auto t0 = scribo::trace::now();
+  {
+    scribo_entering("after");
+  }
+  scribo::trace::enable(false);
+
+  auto events = export_trace(t0)["traceEvents"];
+  ASSERT_EQ(events.size(), 1);
+  ASSERT_EQ(events[0]["name"], "after");
+}
+
+// The buffers of the exited threads are reused once cleared: the thread ids (and the memory) do not grow with the
+// number of threads
+TEST(UTTracing, ThreadBuffersReused)
+{
+  constexpr int kThreads = 4;
+
+  scribo::trace::clear();
+  scribo::trace::enable();
+
+  std::set<int> first;
+  for (int round = 0; round < 5; ++round)
+  {
+    for (int k = 0; k < kThreads; ++k)
+      std::thread([] { scribo_entering("span"); }).join();
+
+    auto events = export_trace()["traceEvents"];
+    ASSERT_EQ(events.size(), kThreads);
+
+    std::set<int> tids;
+    for (const auto& e : events)
+      tids.insert(e["tid"].get<int>());
+    ASSERT_EQ(tids.size(), kThreads); // The events of an exited thread are kept until cleared
+    if (round == 0)
+      first = tids;
+    ASSERT_EQ(tids, first);
+    scribo::trace::clear();
+  }
+
+  // A living thread keeps recording after a clear
+  {
+    scribo_entering("main-1");
+  }
+  scribo::trace::clear();
+  for (int i = 0; i < 2000; ++i)
+  {
+    scribo_entering("main-2");
+  }
+  scribo::trace::enable(false);
+  ASSERT_EQ(export_trace()["traceEvents"].size(), 2000);
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include "../src/watershed.hpp"
+
+#include <mln/core/algorithm/clone.hpp>
+#include <mln/core/image/ndimage.hpp>
+#include <mln/core/neighborhood/c4.hpp>
+
+#include <map>
+#include <random>
+
+
+static mln::image2d<uint8_t> make_input(int width, int height, int n_levels, unsigned seed)
+{
+  std::mt19937          gen(seed);
+  mln::image2d<uint8_t> input(width, height);
+  for (int y = 0; y < height; ++y)
+    for (int x = 0; x < width; ++x)
+      input({x, y}) = static_cast<uint8_t>((gen() % n_levels) * (256 / n_levels));
+  return input;
+}
+
+// True if a and b have the same waterlines and the same basins (up to a relabeling)
+static bool same_partition(const mln::image2d<int16_t>& a, const mln::image2d<int16_t>& b)
+{
+  std::map<int, int> a2b, b2a;
+  for (int y = 0; y < a.height(); ++y)
+    for (int x = 0; x < a.width(); ++x)
+    {
+      int u = a({x, y}), v = b({x, y});
+      if ((u == 0) != (v == 0))
+        return false;
+      if (*a2b.try_emplace(u, v).first != std::pair<const int, int>{u, v} ||
+          *b2a.try_emplace(v, u).first != std::pair<const int, int>{v, u})
+        return false;
+    }
+  return true;
+}
+
+
+TEST(UTWatershed, HQueueSameAsPQueue) {
+  for (unsigned seed = 0; seed < 20; ++seed)
+  {
+    auto input = make_input(67, 43, (seed % 2) ? 256 : 8, seed);
+
+    // Random markers
+    std::mt19937          gen(seed);
+    mln::image2d<int16_t> markers(67, 43);
+    int                   nlabel = 0;
+    for (int y = 0; y < 43; ++y)
+      for (int x = 0; x < 67; ++x)
+        markers({x, y}) = (gen() % 50 == 0) ? ++nlabel : 0;
+
+    mln::image2d<int16_t> ref = mln::clone(markers);
+    mln::image2d<int16_t> out = mln::clone(markers);
+    impl::watershed_pqueue(input, mln::c4, ref, nlabel);
+    impl::watershed_hqueue(input, out, nlabel);
+
+    for (int y = 0; y < 43; ++y)
+      for (int x = 0; x < 67; ++x)
+        ASSERT_EQ(out({x, y}), ref({x, y})) << "seed=" << seed << " x=" << x << " y=" << y;
+  }
+}
+
+TEST(UTWatershed, SameAsPylene) {
+  for (unsigned seed = 0; seed < 10; ++seed)
+  {
+    auto input = make_input(80, 60, (seed % 2) ? 256 : 8, seed);
+
+    int  n1, n2;
+    auto ref = mln::morpho::watershed<int16_t>(input, mln::c4, n1);
+    auto out = impl::watershed<int16_t>(input, mln::c4, n2);
+    ASSERT_EQ(n1, n2);
+    ASSERT_TRUE(same_partition(ref, out)) << "seed=" << seed;
+  }
+}
+
+TEST(UTWatershed, LocalMinimaOverflow) {
+  // Checkerboard: every black pixel is a minimum (128 minima)
+  mln::image2d<uint8_t> input(16, 16);
+  for (int y = 0; y < 16; ++y)
+    for (int x = 0; x < 16; ++x)
+      input({x, y}) = ((x + y) % 2) ? 255 : 0;
+
+  mln::image2d<int8_t> out8;
+  out8.resize(input.domain());
+  EXPECT_THROW(impl::local_minima(input, out8), std::runtime_error);
+
+  mln::image2d<int16_t> out16;
+  out16.resize(input.domain());
+  EXPECT_EQ(impl::local_minima(input, out16), 128);
+}
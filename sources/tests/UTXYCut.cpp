@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <scribo.hpp>
+#include "../src/config.hpp"
+
+#include <mln/core/image/ndimage.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+
+namespace
+{
+  constexpr int kXHeight = 14;
+
+  void fill_rect(mln::image2d<uint8_t>& ima, int x0, int y0, int w, int h, uint8_t v)
+  {
+    for (int y = y0; y < y0 + h; ++y)
+      for (int x = x0; x < x0 + w; ++x)
+        ima({x, y}) = v;
+  }
+
+  Segment make_segment(int x0, int y0, int x1, int y1)
+  {
+    Segment s;
+    s.start  = {x0, y0};
+    s.end    = {x1, y1};
+    s.width  = 3;
+    s.nfa    = 0;
+    s.length = std::hypot(x1 - x0, y1 - y0);
+    s.angle  = std::atan2(y1 - y0, x1 - x0) * 180 / M_PI;
+    return s;
+  }
+
+  // White page with `ncols` columns of text lines separated by vertical rules
+  mln::image2d<uint8_t> make_page(int width, int height, int ncols, std::vector<Segment>& rules)
+  {
+    constexpr int kMargin = 100;
+    constexpr int kGutter = 60;
+
+    std::mt19937          gen(7);
+    mln::image2d<uint8_t> input(width, height);
+    fill_rect(input, 0, 0, width, height, 230);
+
+    int colwidth = (width - 2 * kMargin - (ncols - 1) * kGutter) / ncols;
+    for (int c = 0; c < ncols; ++c)
+    {
+      int x0 = kMargin + c * (colwidth + kGutter);
+      if (c > 0)
+      {
+        int x = x0 - kGutter / 2;
+        fill_rect(input, x, kMargin, 3, height - 2 * kMargin, 40);
+        rules.push_back(make_segment(x + 1, kMargin, x + 1, height - kMargin - 1));
+      }
+      for (int y = kMargin + 20; y + 36 < height - kMargin; y += 36)
+        for (int x = x0 + (gen() % 2) * 30; x + 12 < x0 + colwidth - int(gen() % 100); x += 12)
+          if (gen() % 6 != 0) // Word spacing
+            fill_rect(input, x, y, 10, kXHeight, 40);
+    }
+    return input;
+  }
+} // namespace
+
+
+// The concurrent splits give the same regions, in the same (depth-first) order, as the sequential ones
+TEST(UTXYCut, ParallelMatchesSequential)
+{
+  std::vector<Segment> rules;
+  auto                 input = make_page(2800, 2000, 7, rules);
+
+  KConfig config;
+  config.set_xheight(kXHeight, 1);
+
+  auto segments = rules;
+  auto ref      = scribo::XYCutLayoutExtraction(input, segments, config, 1);
+
+  auto ncolumns = std::ranges::count_if(ref, [](const auto& r) { return r.type == DOMCategory::COLUMN_LEVEL_1; });
+  ASSERT_EQ(ncolumns, 7);
+
+  for (int n_threads : {0, 2, 3, 16})
+  {
+    segments = rules;
+    auto out = scribo::XYCutLayoutExtraction(input, segments, config, n_threads);
+    ASSERT_EQ(out.size(), ref.size()) << "n_threads=" << n_threads;
+    for (std::size_t i = 0; i < ref.size(); ++i)
+    {
+      EXPECT_EQ(out[i].type, ref[i].type) << "n_threads=" << n_threads << " region " << i;
+      EXPECT_EQ(out[i].parent_id, ref[i].parent_id) << "n_threads=" << n_threads << " region " << i;
+      EXPECT_EQ(out[i].bbox.x, ref[i].bbox.x);
+      EXPECT_EQ(out[i].bbox.y, ref[i].bbox.y);
+      EXPECT_EQ(out[i].bbox.width, ref[i].bbox.width);
+      EXPECT_EQ(out[i].bbox.height, ref[i].bbox.height);
+    }
+  }
+}
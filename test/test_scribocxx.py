@@ -0,0 +1,52 @@
+import gc
+import os.path as osp
+import sys
+import weakref
+
+import numpy as np
+import pytest
+
+sys.path.append(osp.join(osp.dirname(osp.abspath(__file__)), "../back"))
+scribocxx = pytest.importorskip("scribocxx")
+
+
+def make_page(height=1500, width=2048, seed=0):
+    '''
+    White page with two columns of text lines (small dark boxes)
+    '''
+    rng = np.random.default_rng(seed)
+    page = np.full((height, width), 230, dtype=np.uint8)
+    for x0 in (100, 1100):
+        for y in range(120, height - 120, 36):
+            x = x0 + 30 * int(rng.integers(2))
+            while x + 12 < x0 + 850:
+                if rng.integers(6) != 0:
+                    page[y:y + 14, x:x + 10] = 40
+                x += 12
+    return page
+
+
+def test_page_options_keep_alive():
+    '''
+    The objects assigned to PageOptions.config and PageOptions.entry_model are kept alive by the options
+    '''
+    opts = scribocxx.PageOptions()
+
+    config = scribocxx.KConfig()
+    config.kLayoutWhiteLevel = 140
+    config_ref = weakref.ref(config)
+    opts.config = config
+    opts.entry_model = scribocxx.EntryModel()
+    del config
+    gc.collect()
+
+    assert config_ref() is not None
+    assert opts.config.kLayoutWhiteLevel == 140
+    assert opts.entry_model is not None
+
+    # Temporaries only
+    opts.config = scribocxx.KConfig()
+    gc.collect()
+    _, ws, regions, params = scribocxx.process_page(make_page(), opts)
+    assert params["xheight"] > 0
+    assert len(regions) > 0
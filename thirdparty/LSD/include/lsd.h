@@ -142,6 +142,35 @@ double * LineSegmentDetection( int * n_out,
                                int n_bins,
                                int ** reg_img, int * reg_x, int * reg_y );
 
+/*----------------------------------------------------------------------------*/
+/** LSD full interface on 8-bit images
+
+    Same as LineSegmentDetection() but the input is an 8-bit image and the
+    sub-sampling is restricted to integer factors. The input is first
+    sub-sampled by a (1/scale) x (1/scale) box filter, then the remaining
+    part of the Gaussian filter is applied on the reduced image. No
+    full-resolution double image is allocated.
+
+    @param img         Pointer to input image data. The pixel at coordinates
+                       (x,y) is obtained by img[x+y*stride].
+
+    @param stride      Number of bytes between two consecutive rows
+                       (stride >= X).
+
+    @param scale       Sub-sampling factor. It must be the inverse of an
+                       integer (1.0, 0.5, 0.333...).
+                       Suggested value: 0.5
+
+    The other parameters and the returned value are the same as in
+    LineSegmentDetection(). The region output is not available.
+ */
+double * LineSegmentDetection_u8( int * n_out,
+                                  const unsigned char * img, int X, int Y,
+                                  int stride,
+                                  double scale, double sigma_scale,
+                                  double quant, double ang_th, double log_eps,
+                                  double density_th, int n_bins );
+
 /*----------------------------------------------------------------------------*/
 /** LSD Simple Interface with Scale and Region output.
 
@@ -727,6 +727,66 @@ static image_double gaussian_sampler( image_double in, double scale,
   return out;
 }
 
+/*----------------------------------------------------------------------------*/
+/** Sub-sample the 8-bit input image 'img' by an integer factor 'k'
+    with a k x k box filter.
+
+    The input pixel at (x,y) is obtained by img[x+y*stride]. The
+    output image has size ceil(X/k) x ceil(Y/k); the boxes on the
+    right and bottom borders are averaged over the available pixels.
+
+    The output pixel (x,y) is the mean of the input pixels
+    [k.x, k.x+k) x [k.y, k.y+k), so its center corresponds to the
+    coordinates (k.x + (k-1)/2, k.y + (k-1)/2) in the input image.
+ */
+static image_double box_sampler_u8( const unsigned char * img, int X, int Y,
+                                    int stride, unsigned int k )
+{
+  image_double out;
+  unsigned int * acc;
+  const unsigned char * row;
+  unsigned int N,M,x,y,xx,yy,y1,nx,ny,j;
+
+  /* check parameters */
+  if( img == NULL || X <= 0 || Y <= 0 )
+    error("box_sampler_u8: invalid image.");
+  if( stride < X ) error("box_sampler_u8: invalid stride.");
+  if( k == 0 ) error("box_sampler_u8: 'k' must be positive.");
+
+  /* compute new image size and get memory */
+  N = ( (unsigned int) X + k - 1 ) / k;
+  M = ( (unsigned int) Y + k - 1 ) / k;
+  out = new_image_double(N,M);
+  acc = (unsigned int *) malloc( (size_t) N * sizeof(unsigned int) );
+  if( acc == NULL ) error("not enough memory.");
+
+  for(y=0;y<M;y++)
+    {
+      /* sum the rows of the box line by line (contiguous reads) */
+      for(x=0;x<N;x++) acc[x] = 0;
+      y1 = k * (y+1) < (unsigned int) Y ? k * (y+1) : (unsigned int) Y;
+      for(yy=k*y;yy<y1;yy++)
+        {
+          row = img + (size_t) yy * (size_t) stride;
+          for(x=0,xx=0;x<N;x++)
+            for(j=0;j<k && xx<(unsigned int) X;j++,xx++)
+              acc[x] += row[xx];
+        }
+
+      /* normalize */
+      ny = y1 - k*y;
+      for(x=0;x<N;x++)
+        {
+          nx = k * (x+1) < (unsigned int) X ? k : (unsigned int) X - k*x;
+          out->data[ x + y * out->xsize ] = (double) acc[x] / (double) (nx*ny);
+        }
+    }
+
+  free( (void *) acc );
+
+  return out;
+}
+
 
 /*----------------------------------------------------------------------------*/
 /*--------------------------------- Gradient ---------------------------------*/
@@ -2020,19 +2080,21 @@ static int refine( struct point * reg, int * reg_size, image_double modgrad,
 /*----------------------------------------------------------------------------*/
 
 /*----------------------------------------------------------------------------*/
-/** LSD full interface.
+/** LSD core: detect the line segments on an image that has already been
+    scaled and filtered.
+
+    'image' is not freed. A point (x,y) of 'image' is mapped back to the
+    coordinates (x/scale + offset, y/scale + offset) of the original image.
  */
-double * LineSegmentDetection( int * n_out,
-                               double * img, int X, int Y,
-                               double scale, double sigma_scale, double quant,
-                               double ang_th, double log_eps, double density_th,
-                               int n_bins,
-                               int ** reg_img, int * reg_x, int * reg_y )
+static double * lsd_detect( int * n_out, image_double image,
+                            double scale, double offset, double quant,
+                            double ang_th, double log_eps, double density_th,
+                            int n_bins,
+                            int ** reg_img, int * reg_x, int * reg_y )
 {
-  image_double image;
   ntuple_list out = new_ntuple_list(7);
   double * return_value;
-  image_double scaled_image,angles,modgrad;
+  image_double angles,modgrad;
   image_char used;
   image_int region = NULL;
   struct coorlist * list_p;
@@ -2045,36 +2107,15 @@ double * LineSegmentDetection( int * n_out,
   int ls_count = 0;                   /* line segments are numbered 1,2,3,... */
 
 
-  /* check parameters */
-  if( img == NULL || X <= 0 || Y <= 0 ) error("invalid image input.");
-  if( scale <= 0.0 ) error("'scale' value must be positive.");
-  if( sigma_scale <= 0.0 ) error("'sigma_scale' value must be positive.");
-  if( quant < 0.0 ) error("'quant' value must be positive.");
-  if( ang_th <= 0.0 || ang_th >= 180.0 )
-    error("'ang_th' value must be in the range (0,180).");
-  if( density_th < 0.0 || density_th > 1.0 )
-    error("'density_th' value must be in the range [0,1].");
-  if( n_bins <= 0 ) error("'n_bins' value must be positive.");
-
-
   /* angle tolerance */
   prec = M_PI * ang_th / 180.0;
   p = ang_th / 180.0;
   rho = quant / sin(prec); /* gradient magnitude threshold */
 
 
-  /* load and scale image (if necessary) and compute angle at each pixel */
-  image = new_image_double_ptr( (unsigned int) X, (unsigned int) Y, img );
-  if( scale != 1.0 )
-    {
-      scaled_image = gaussian_sampler( image, scale, sigma_scale );
-      angles = ll_angle( scaled_image, rho, &list_p, &mem_p,
-                         &modgrad, (unsigned int) n_bins );
-      free_image_double(scaled_image);
-    }
-  else
-    angles = ll_angle( image, rho, &list_p, &mem_p, &modgrad,
-                       (unsigned int) n_bins );
+  /* compute angle at each pixel */
+  angles = ll_angle( image, rho, &list_p, &mem_p, &modgrad,
+                     (unsigned int) n_bins );
   xsize = angles->xsize;
   ysize = angles->ysize;
 
@@ -2156,6 +2197,8 @@ double * LineSegmentDetection( int * n_out,
             rec.x2 /= scale; rec.y2 /= scale;
             rec.width /= scale;
           }
+        rec.x1 += offset; rec.y1 += offset;
+        rec.x2 += offset; rec.y2 += offset;
 
         /* add line segment found to output */
         add_7tuple( out, rec.x1, rec.y1, rec.x2, rec.y2,
@@ -2169,9 +2212,6 @@ double * LineSegmentDetection( int * n_out,
 
 
   /* free memory */
-  free( (void *) image );   /* only the double_image structure should be freed,
-                               the data pointer was provided to this functions
-                               and should not be destroyed.                 */
   free_image_double(angles);
   free_image_double(modgrad);
   free_image_char(used);
@@ -2206,6 +2246,111 @@ double * LineSegmentDetection( int * n_out,
   return return_value;
 }
 
+
+/*----------------------------------------------------------------------------*/
+/** LSD full interface.
+ */
+double * LineSegmentDetection( int * n_out,
+                               double * img, int X, int Y,
+                               double scale, double sigma_scale, double quant,
+                               double ang_th, double log_eps, double density_th,
+                               int n_bins,
+                               int ** reg_img, int * reg_x, int * reg_y )
+{
+  image_double image,scaled_image;
+  double * return_value;
+
+  /* check parameters */
+  if( img == NULL || X <= 0 || Y <= 0 ) error("invalid image input.");
+  if( scale <= 0.0 ) error("'scale' value must be positive.");
+  if( sigma_scale <= 0.0 ) error("'sigma_scale' value must be positive.");
+  if( quant < 0.0 ) error("'quant' value must be positive.");
+  if( ang_th <= 0.0 || ang_th >= 180.0 )
+    error("'ang_th' value must be in the range (0,180).");
+  if( density_th < 0.0 || density_th > 1.0 )
+    error("'density_th' value must be in the range [0,1].");
+  if( n_bins <= 0 ) error("'n_bins' value must be positive.");
+
+  /* load and scale image (if necessary) */
+  image = new_image_double_ptr( (unsigned int) X, (unsigned int) Y, img );
+  if( scale != 1.0 )
+    {
+      scaled_image = gaussian_sampler( image, scale, sigma_scale );
+      return_value = lsd_detect( n_out, scaled_image, scale, 0.0, quant,
+                                 ang_th, log_eps, density_th, n_bins,
+                                 reg_img, reg_x, reg_y );
+      free_image_double(scaled_image);
+    }
+  else
+    return_value = lsd_detect( n_out, image, 1.0, 0.0, quant,
+                               ang_th, log_eps, density_th, n_bins,
+                               reg_img, reg_x, reg_y );
+
+  free( (void *) image );   /* only the double_image structure should be freed,
+                               the data pointer was provided to this functions
+                               and should not be destroyed.                 */
+  return return_value;
+}
+
+/*----------------------------------------------------------------------------*/
+/** LSD full interface on 8-bit images.
+ */
+double * LineSegmentDetection_u8( int * n_out,
+                                  const unsigned char * img, int X, int Y,
+                                  int stride,
+                                  double scale, double sigma_scale,
+                                  double quant, double ang_th, double log_eps,
+                                  double density_th, int n_bins )
+{
+  image_double image,scaled_image;
+  double * return_value;
+  unsigned int k;
+  double sigma,var;
+
+  /* check parameters */
+  if( img == NULL || X <= 0 || Y <= 0 ) error("invalid image input.");
+  if( stride < X ) error("'stride' value must be at least X.");
+  if( scale <= 0.0 || scale > 1.0 )
+    error("'scale' value must be in the range (0,1].");
+  k = (unsigned int) floor( 1.0 / scale + 0.5 );
+  if( !double_equal( (double) k * scale, 1.0 ) )
+    error("'scale' value must be the inverse of an integer.");
+  if( sigma_scale <= 0.0 ) error("'sigma_scale' value must be positive.");
+  if( quant < 0.0 ) error("'quant' value must be positive.");
+  if( ang_th <= 0.0 || ang_th >= 180.0 )
+    error("'ang_th' value must be in the range (0,180).");
+  if( density_th < 0.0 || density_th > 1.0 )
+    error("'density_th' value must be in the range [0,1].");
+  if( n_bins <= 0 ) error("'n_bins' value must be positive.");
+
+  /* sub-sample with a k x k box filter (this is the only full-resolution
+     pass, it reads 1 byte per pixel) */
+  image = box_sampler_u8( img, X, Y, stride, k );
+
+  /* The box filter already smoothed the image with a variance (k^2-1)/12
+     (in input pixels). The remaining part of the Gaussian of standard
+     deviation sigma_scale/scale is applied at the reduced resolution. */
+  if( k > 1 )
+    {
+      sigma = sigma_scale / scale;
+      var = sigma * sigma - ( (double) (k*k) - 1.0 ) / 12.0;
+      if( var > 0.0 )
+        {
+          scaled_image = gaussian_sampler( image, 1.0, sqrt(var) / (double) k );
+          free_image_double(image);
+          image = scaled_image;
+        }
+    }
+
+  /* the center of the output pixel x is at k.x + (k-1)/2 in the input */
+  return_value = lsd_detect( n_out, image, scale, ( (double) k - 1.0 ) / 2.0,
+                             quant, ang_th, log_eps, density_th, n_bins,
+                             NULL, NULL, NULL );
+  free_image_double(image);
+
+  return return_value;
+}
+
 /*----------------------------------------------------------------------------*/
 /** LSD Simple Interface with Scale and Region output.
  */